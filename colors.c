@@ -2,7 +2,7 @@
  * @file colors.c
  * @brief This file contains an array of color names in alphabetical order.
  * 
- * This file contains an array of color names in alphabetical order, which can be used for various purposes such as 
+ * This file contains an array of color names in alphabetical order, and their RGB values, which can be used for various purposes such as 
  * setting colors in graphical applications or generating random colors.
  */
 char* colornames[] = {
@@ -511,3 +511,514 @@ char* colornames[] = {
      "yellow4",
      "yellowgreen"
 };
+
+/**
+ * @brief The RGB value of each color name, as 0xRRGGBB, taken from the X11 rgb.txt file.
+ * The names X11 does not know are black, as Graphviz draws them.
+ */
+unsigned int colorvalues[] = {
+     0xf0f8ff, /* aliceblue */
+     0xfaebd7, /* antiquewhite */
+     0xffefdb, /* antiquewhite1 */
+     0xeedfcc, /* antiquewhite2 */
+     0xcdc0b0, /* antiquewhite3 */
+     0x8b8378, /* antiquewhite4 */
+     0x7fffd4, /* aquamarine1 */
+     0x76eec6, /* aquamarine2 */
+     0x458b74, /* aquamarine4 */
+     0xf0ffff, /* azure1 */
+     0xe0eeee, /* azure2 */
+     0xc1cdcd, /* azure3 */
+     0x838b8b, /* azure4 */
+     0xf5f5dc, /* beige */
+     0xffe4c4, /* bisque1 */
+     0xeed5b7, /* bisque2 */
+     0xcdb79e, /* bisque3 */
+     0x8b7d6b, /* bisque4 */
+     0x000000, /* black */
+     0xffebcd, /* blanchedalmond */
+     0x0000ff, /* blue1 */
+     0x0000ee, /* blue2 */
+     0x00008b, /* blue4 */
+     0x8a2be2, /* blueviolet */
+     0xa52a2a, /* brown */
+     0xff4040, /* brown1 */
+     0xee3b3b, /* brown2 */
+     0xcd3333, /* brown3 */
+     0x8b2323, /* brown4 */
+     0xdeb887, /* burlywood */
+     0xffd39b, /* burlywood1 */
+     0xeec591, /* burlywood2 */
+     0xcdaa7d, /* burlywood3 */
+     0x8b7355, /* burlywood4 */
+     0x5f9ea0, /* cadetblue */
+     0x98f5ff, /* cadetblue1 */
+     0x8ee5ee, /* cadetblue2 */
+     0x7ac5cd, /* cadetblue3 */
+     0x53868b, /* cadetblue4 */
+     0x7fff00, /* chartreuse1 */
+     0x76ee00, /* chartreuse2 */
+     0x66cd00, /* chartreuse3 */
+     0x458b00, /* chartreuse4 */
+     0xd2691e, /* chocolate */
+     0xff7f24, /* chocolate1 */
+     0xee7621, /* chocolate2 */
+     0xcd661d, /* chocolate3 */
+     0xff7f50, /* coral */
+     0xff7256, /* coral1 */
+     0xee6a50, /* coral2 */
+     0xcd5b45, /* coral3 */
+     0x8b3e2f, /* coral4 */
+     0x6495ed, /* cornflowerblue */
+     0xfff8dc, /* cornsilk1 */
+     0xeee8cd, /* cornsilk2 */
+     0xcdc8b1, /* cornsilk3 */
+     0x8b8878, /* cornsilk4 */
+     0x00ffff, /* cyan1 */
+     0x00eeee, /* cyan2 */
+     0x00cdcd, /* cyan3 */
+     0x008b8b, /* cyan4 */
+     0xb8860b, /* darkgoldenrod */
+     0xffb90f, /* darkgoldenrod1 */
+     0xeead0e, /* darkgoldenrod2 */
+     0xcd950c, /* darkgoldenrod3 */
+     0x8b6508, /* darkgoldenrod4 */
+     0x006400, /* darkgreen */
+     0xbdb76b, /* darkkhaki */
+     0x556b2f, /* darkolivegreen */
+     0xcaff70, /* darkolivegreen1 */
+     0xbcee68, /* darkolivegreen2 */
+     0xa2cd5a, /* darkolivegreen3 */
+     0x6e8b3d, /* darkolivegreen4 */
+     0xff8c00, /* darkorange */
+     0xff7f00, /* darkorange1 */
+     0xee7600, /* darkorange2 */
+     0xcd6600, /* darkorange3 */
+     0x8b4500, /* darkorange4 */
+     0x9932cc, /* darkorchid */
+     0xbf3eff, /* darkorchid1 */
+     0xb23aee, /* darkorchid2 */
+     0x9a32cd, /* darkorchid3 */
+     0x68228b, /* darkorchid4 */
+     0xe9967a, /* darksalmon */
+     0x8fbc8f, /* darkseagreen */
+     0xc1ffc1, /* darkseagreen1 */
+     0xb4eeb4, /* darkseagreen2 */
+     0x9bcd9b, /* darkseagreen3 */
+     0x698b69, /* darkseagreen4 */
+     0x483d8b, /* darkslateblue */
+     0x2f4f4f, /* darkslategray */
+     0x97ffff, /* darkslategray1 */
+     0x8deeee, /* darkslategray2 */
+     0x79cdcd, /* darkslategray3 */
+     0x528b8b, /* darkslategray4 */
+     0x00ced1, /* darkturquoise */
+     0x9400d3, /* darkviolet */
+     0xff1493, /* deeppink1 */
+     0xee1289, /* deeppink2 */
+     0xcd1076, /* deeppink3 */
+     0x8b0a50, /* deeppink4 */
+     0x00bfff, /* deepskyblue1 */
+     0x00b2ee, /* deepskyblue2 */
+     0x009acd, /* deepskyblue3 */
+     0x00688b, /* deepskyblue4 */
+     0x696969, /* dimgray */
+     0x1e90ff, /* dodgerblue1 */
+     0x1c86ee, /* dodgerblue2 */
+     0x1874cd, /* dodgerblue3 */
+     0x104e8b, /* dodgerblue4 */
+     0xb22222, /* firebrick */
+     0xff3030, /* firebrick1 */
+     0xee2c2c, /* firebrick2 */
+     0xcd2626, /* firebrick3 */
+     0x8b1a1a, /* firebrick4 */
+     0xfffaf0, /* floralwhite */
+     0x228b22, /* forestgreen */
+     0xdcdcdc, /* gainsboro */
+     0xf8f8ff, /* ghostwhite */
+     0xffd700, /* gold1 */
+     0xeec900, /* gold2 */
+     0xcdad00, /* gold3 */
+     0x8b7500, /* gold4 */
+     0xdaa520, /* goldenrod */
+     0xffc125, /* goldenrod1 */
+     0xeeb422, /* goldenrod2 */
+     0xcd9b1d, /* goldenrod3 */
+     0x8b6914, /* goldenrod4 */
+     0xbebebe, /* gray */
+     0x030303, /* gray1 */
+     0x050505, /* gray2 */
+     0x080808, /* gray3 */
+     0x0a0a0a, /* gray4 */
+     0x0d0d0d, /* gray5 */
+     0x0f0f0f, /* gray6 */
+     0x121212, /* gray7 */
+     0x141414, /* gray8 */
+     0x171717, /* gray9 */
+     0x1a1a1a, /* gray10 */
+     0x1c1c1c, /* gray11 */
+     0x1f1f1f, /* gray12 */
+     0x212121, /* gray13 */
+     0x242424, /* gray14 */
+     0x262626, /* gray15 */
+     0x292929, /* gray16 */
+     0x2b2b2b, /* gray17 */
+     0x2e2e2e, /* gray18 */
+     0x303030, /* gray19 */
+     0x333333, /* gray20 */
+     0x363636, /* gray21 */
+     0x383838, /* gray22 */
+     0x3b3b3b, /* gray23 */
+     0x3d3d3d, /* gray24 */
+     0x404040, /* gray25 */
+     0x424242, /* gray26 */
+     0x454545, /* gray27 */
+     0x474747, /* gray28 */
+     0x4a4a4a, /* gray29 */
+     0x4d4d4d, /* gray30 */
+     0x4f4f4f, /* gray31 */
+     0x525252, /* gray32 */
+     0x545454, /* gray33 */
+     0x575757, /* gray34 */
+     0x595959, /* gray35 */
+     0x5c5c5c, /* gray36 */
+     0x5e5e5e, /* gray37 */
+     0x616161, /* gray38 */
+     0x636363, /* gray39 */
+     0x666666, /* gray40 */
+     0x696969, /* gray41 */
+     0x6b6b6b, /* gray42 */
+     0x6e6e6e, /* gray43 */
+     0x707070, /* gray44 */
+     0x737373, /* gray45 */
+     0x757575, /* gray46 */
+     0x787878, /* gray47 */
+     0x7a7a7a, /* gray48 */
+     0x7d7d7d, /* gray49 */
+     0x7f7f7f, /* gray50 */
+     0x828282, /* gray51 */
+     0x858585, /* gray52 */
+     0x878787, /* gray53 */
+     0x8a8a8a, /* gray54 */
+     0x8c8c8c, /* gray55 */
+     0x8f8f8f, /* gray56 */
+     0x919191, /* gray57 */
+     0x949494, /* gray58 */
+     0x969696, /* gray59 */
+     0x999999, /* gray60 */
+     0x9c9c9c, /* gray61 */
+     0x9e9e9e, /* gray62 */
+     0xa1a1a1, /* gray63 */
+     0xa3a3a3, /* gray64 */
+     0xa6a6a6, /* gray65 */
+     0xa8a8a8, /* gray66 */
+     0xababab, /* gray67 */
+     0xadadad, /* gray68 */
+     0xb0b0b0, /* gray69 */
+     0xb3b3b3, /* gray70 */
+     0xb5b5b5, /* gray71 */
+     0xb8b8b8, /* gray72 */
+     0xbababa, /* gray73 */
+     0xbdbdbd, /* gray74 */
+     0xbfbfbf, /* gray75 */
+     0xc2c2c2, /* gray76 */
+     0xc4c4c4, /* gray77 */
+     0xc7c7c7, /* gray78 */
+     0xc9c9c9, /* gray79 */
+     0xcccccc, /* gray80 */
+     0xcfcfcf, /* gray81 */
+     0xd1d1d1, /* gray82 */
+     0xd4d4d4, /* gray83 */
+     0xd6d6d6, /* gray84 */
+     0xd9d9d9, /* gray85 */
+     0xdbdbdb, /* gray86 */
+     0xdedede, /* gray87 */
+     0xe0e0e0, /* gray88 */
+     0xe3e3e3, /* gray89 */
+     0xe5e5e5, /* gray90 */
+     0xe8e8e8, /* gray91 */
+     0xebebeb, /* gray92 */
+     0xededed, /* gray93 */
+     0xf0f0f0, /* gray94 */
+     0xf2f2f2, /* gray95 */
+     0xf7f7f7, /* gray97 */
+     0xfafafa, /* gray98 */
+     0xfcfcfc, /* gray99 */
+     0x00ff00, /* green1 */
+     0x00ee00, /* green2 */
+     0x00cd00, /* green3 */
+     0x008b00, /* green4 */
+     0xadff2f, /* greenyellow */
+     0xf0fff0, /* honeydew1 */
+     0xe0eee0, /* honeydew2 */
+     0xc1cdc1, /* honeydew3 */
+     0x838b83, /* honeydew4 */
+     0xff69b4, /* hotpink */
+     0xff6eb4, /* hotpink1 */
+     0xee6aa7, /* hotpink2 */
+     0xcd6090, /* hotpink3 */
+     0x8b3a62, /* hotpink4 */
+     0xcd5c5c, /* indianred */
+     0xff6a6a, /* indianred1 */
+     0xee6363, /* indianred2 */
+     0xcd5555, /* indianred3 */
+     0x8b3a3a, /* indianred4 */
+     0xfffff0, /* ivory1 */
+     0xeeeee0, /* ivory2 */
+     0xcdcdc1, /* ivory3 */
+     0x8b8b83, /* ivory4 */
+     0xf0e68c, /* khaki */
+     0xfff68f, /* khaki1 */
+     0xeee685, /* khaki2 */
+     0xcdc673, /* khaki3 */
+     0x8b864e, /* khaki4 */
+     0xe6e6fa, /* lavender */
+     0xfff0f5, /* lavenderblush1 */
+     0xeee0e5, /* lavenderblush2 */
+     0xcdc1c5, /* lavenderblush3 */
+     0x8b8386, /* lavenderblush4 */
+     0x7cfc00, /* lawngreen */
+     0xfffacd, /* lemonchiffon1 */
+     0xeee9bf, /* lemonchiffon2 */
+     0xcdc9a5, /* lemonchiffon3 */
+     0x8b8970, /* lemonchiffon4 */
+     0x000000, /* light */
+     0xadd8e6, /* lightblue */
+     0xbfefff, /* lightblue1 */
+     0xb2dfee, /* lightblue2 */
+     0x9ac0cd, /* lightblue3 */
+     0x68838b, /* lightblue4 */
+     0xf08080, /* lightcoral */
+     0xe0ffff, /* lightcyan1 */
+     0xd1eeee, /* lightcyan2 */
+     0xb4cdcd, /* lightcyan3 */
+     0x7a8b8b, /* lightcyan4 */
+     0xffec8b, /* lightgoldenrod1 */
+     0xeedc82, /* lightgoldenrod2 */
+     0xcdbe70, /* lightgoldenrod3 */
+     0x8b814c, /* lightgoldenrod4 */
+     0x000000, /* lightgoldenrodye */
+     0xd3d3d3, /* lightgray */
+     0xffb6c1, /* lightpink */
+     0xffaeb9, /* lightpink1 */
+     0xeea2ad, /* lightpink2 */
+     0xcd8c95, /* lightpink3 */
+     0x8b5f65, /* lightpink4 */
+     0xffa07a, /* lightsalmon1 */
+     0xee9572, /* lightsalmon2 */
+     0xcd8162, /* lightsalmon3 */
+     0x8b5742, /* lightsalmon4 */
+     0x20b2aa, /* lightseagreen */
+     0x87cefa, /* lightskyblue */
+     0xb0e2ff, /* lightskyblue1 */
+     0xa4d3ee, /* lightskyblue2 */
+     0x8db6cd, /* lightskyblue3 */
+     0x607b8b, /* lightskyblue4 */
+     0x8470ff, /* lightslateblue */
+     0x778899, /* lightslategray */
+     0xb0c4de, /* lightsteelblue */
+     0xcae1ff, /* lightsteelblue1 */
+     0xbcd2ee, /* lightsteelblue2 */
+     0xa2b5cd, /* lightsteelblue3 */
+     0x6e7b8b, /* lightsteelblue4 */
+     0xffffe0, /* lightyellow1 */
+     0xeeeed1, /* lightyellow2 */
+     0xcdcdb4, /* lightyellow3 */
+     0x8b8b7a, /* lightyellow4 */
+     0x32cd32, /* limegreen */
+     0xfaf0e6, /* linen */
+     0xff00ff, /* magenta */
+     0xee00ee, /* magenta2 */
+     0xcd00cd, /* magenta3 */
+     0x8b008b, /* magenta4 */
+     0xb03060, /* maroon */
+     0xff34b3, /* maroon1 */
+     0xee30a7, /* maroon2 */
+     0xcd2990, /* maroon3 */
+     0x8b1c62, /* maroon4 */
+     0x000000, /* medium */
+     0x66cdaa, /* mediumaquamarine */
+     0x0000cd, /* mediumblue */
+     0xba55d3, /* mediumorchid */
+     0xe066ff, /* mediumorchid1 */
+     0xd15fee, /* mediumorchid2 */
+     0xb452cd, /* mediumorchid3 */
+     0x7a378b, /* mediumorchid4 */
+     0x9370db, /* mediumpurple */
+     0xab82ff, /* mediumpurple1 */
+     0x9f79ee, /* mediumpurple2 */
+     0x8968cd, /* mediumpurple3 */
+     0x5d478b, /* mediumpurple4 */
+     0x3cb371, /* mediumseagreen */
+     0x7b68ee, /* mediumslateblue */
+     0x000000, /* mediumspringgree */
+     0x48d1cc, /* mediumturquoise */
+     0xc71585, /* mediumvioletred */
+     0x191970, /* midnightblue */
+     0xf5fffa, /* mintcream */
+     0xffe4e1, /* mistyrose1 */
+     0xeed5d2, /* mistyrose2 */
+     0xcdb7b5, /* mistyrose3 */
+     0x8b7d7b, /* mistyrose4 */
+     0xffe4b5, /* moccasin */
+     0xffdead, /* navajowhite1 */
+     0xeecfa1, /* navajowhite2 */
+     0xcdb38b, /* navajowhite3 */
+     0x8b795e, /* navajowhite4 */
+     0x000080, /* navyblue */
+     0xfdf5e6, /* oldlace */
+     0x6b8e23, /* olivedrab */
+     0xc0ff3e, /* olivedrab1 */
+     0xb3ee3a, /* olivedrab2 */
+     0x698b22, /* olivedrab4 */
+     0xffa500, /* orange1 */
+     0xee9a00, /* orange2 */
+     0xcd8500, /* orange3 */
+     0x8b5a00, /* orange4 */
+     0xff4500, /* orangered1 */
+     0xee4000, /* orangered2 */
+     0xcd3700, /* orangered3 */
+     0x8b2500, /* orangered4 */
+     0xda70d6, /* orchid */
+     0xff83fa, /* orchid1 */
+     0xee7ae9, /* orchid2 */
+     0xcd69c9, /* orchid3 */
+     0x8b4789, /* orchid4 */
+     0x000000, /* pale */
+     0xeee8aa, /* palegoldenrod */
+     0x98fb98, /* palegreen */
+     0x9aff9a, /* palegreen1 */
+     0x90ee90, /* palegreen2 */
+     0x7ccd7c, /* palegreen3 */
+     0x548b54, /* palegreen4 */
+     0xafeeee, /* paleturquoise */
+     0xbbffff, /* paleturquoise1 */
+     0xaeeeee, /* paleturquoise2 */
+     0x96cdcd, /* paleturquoise3 */
+     0x668b8b, /* paleturquoise4 */
+     0xdb7093, /* palevioletred */
+     0xff82ab, /* palevioletred1 */
+     0xee799f, /* palevioletred2 */
+     0xcd6889, /* palevioletred3 */
+     0x8b475d, /* palevioletred4 */
+     0xffefd5, /* papayawhip */
+     0xffdab9, /* peachpuff1 */
+     0xeecbad, /* peachpuff2 */
+     0xcdaf95, /* peachpuff3 */
+     0x8b7765, /* peachpuff4 */
+     0xffc0cb, /* pink */
+     0xffb5c5, /* pink1 */
+     0xeea9b8, /* pink2 */
+     0xcd919e, /* pink3 */
+     0x8b636c, /* pink4 */
+     0xdda0dd, /* plum */
+     0xffbbff, /* plum1 */
+     0xeeaeee, /* plum2 */
+     0xcd96cd, /* plum3 */
+     0x8b668b, /* plum4 */
+     0xb0e0e6, /* powderblue */
+     0xa020f0, /* purple */
+     0x9b30ff, /* purple1 */
+     0x912cee, /* purple2 */
+     0x7d26cd, /* purple3 */
+     0x551a8b, /* purple4 */
+     0xff0000, /* red1 */
+     0xee0000, /* red2 */
+     0xcd0000, /* red3 */
+     0x8b0000, /* red4 */
+     0xbc8f8f, /* rosybrown */
+     0xffc1c1, /* rosybrown1 */
+     0xeeb4b4, /* rosybrown2 */
+     0xcd9b9b, /* rosybrown3 */
+     0x8b6969, /* rosybrown4 */
+     0x4169e1, /* royalblue */
+     0x4876ff, /* royalblue1 */
+     0x436eee, /* royalblue2 */
+     0x3a5fcd, /* royalblue3 */
+     0x27408b, /* royalblue4 */
+     0x8b4513, /* saddlebrown */
+     0xfa8072, /* salmon */
+     0xff8c69, /* salmon1 */
+     0xee8262, /* salmon2 */
+     0xcd7054, /* salmon3 */
+     0x8b4c39, /* salmon4 */
+     0xf4a460, /* sandybrown */
+     0x54ff9f, /* seagreen1 */
+     0x4eee94, /* seagreen2 */
+     0x43cd80, /* seagreen3 */
+     0x2e8b57, /* seagreen4 */
+     0xfff5ee, /* seashell1 */
+     0xeee5de, /* seashell2 */
+     0xcdc5bf, /* seashell3 */
+     0x8b8682, /* seashell4 */
+     0xa0522d, /* sienna */
+     0xff8247, /* sienna1 */
+     0xee7942, /* sienna2 */
+     0xcd6839, /* sienna3 */
+     0x8b4726, /* sienna4 */
+     0x87ceeb, /* skyblue */
+     0x87ceff, /* skyblue1 */
+     0x7ec0ee, /* skyblue2 */
+     0x6ca6cd, /* skyblue3 */
+     0x4a708b, /* skyblue4 */
+     0x6a5acd, /* slateblue */
+     0x836fff, /* slateblue1 */
+     0x7a67ee, /* slateblue2 */
+     0x6959cd, /* slateblue3 */
+     0x473c8b, /* slateblue4 */
+     0x708090, /* slategray */
+     0xc6e2ff, /* slategray1 */
+     0xb9d3ee, /* slategray2 */
+     0x9fb6cd, /* slategray3 */
+     0x6c7b8b, /* slategray4 */
+     0xfffafa, /* snow1 */
+     0xeee9e9, /* snow2 */
+     0xcdc9c9, /* snow3 */
+     0x8b8989, /* snow4 */
+     0x00ff7f, /* springgreen1 */
+     0x00ee76, /* springgreen2 */
+     0x00cd66, /* springgreen3 */
+     0x008b45, /* springgreen4 */
+     0x4682b4, /* steelblue */
+     0x63b8ff, /* steelblue1 */
+     0x5cacee, /* steelblue2 */
+     0x4f94cd, /* steelblue3 */
+     0x36648b, /* steelblue4 */
+     0xd2b48c, /* tan */
+     0xffa54f, /* tan1 */
+     0xee9a49, /* tan2 */
+     0xcd853f, /* tan3 */
+     0x8b5a2b, /* tan4 */
+     0xd8bfd8, /* thistle */
+     0xffe1ff, /* thistle1 */
+     0xeed2ee, /* thistle2 */
+     0xcdb5cd, /* thistle3 */
+     0x8b7b8b, /* thistle4 */
+     0xff6347, /* tomato1 */
+     0xee5c42, /* tomato2 */
+     0xcd4f39, /* tomato3 */
+     0x8b3626, /* tomato4 */
+     0x40e0d0, /* turquoise */
+     0x00f5ff, /* turquoise1 */
+     0x00e5ee, /* turquoise2 */
+     0x00c5cd, /* turquoise3 */
+     0x00868b, /* turquoise4 */
+     0xee82ee, /* violet */
+     0xd02090, /* violetred */
+     0xff3e96, /* violetred1 */
+     0xee3a8c, /* violetred2 */
+     0xcd3278, /* violetred3 */
+     0x8b2252, /* violetred4 */
+     0xf5deb3, /* wheat */
+     0xffe7ba, /* wheat1 */
+     0xeed8ae, /* wheat2 */
+     0xcdba96, /* wheat3 */
+     0x8b7e66, /* wheat4 */
+     0xffffff, /* white */
+     0xf5f5f5, /* whitesmoke */
+     0xffff00, /* yellow1 */
+     0xeeee00, /* yellow2 */
+     0xcdcd00, /* yellow3 */
+     0x8b8b00, /* yellow4 */
+     0x9acd32 /* yellowgreen */
+};
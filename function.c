@@ -5,12 +5,62 @@
 #include <assert.h>
 #include <time.h>
 #include <math.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <signal.h>
+#include <errno.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 
 #define STB_DS_IMPLEMENTATION
 #include "stb_ds.h"
 #include "colors.c"
 #define BUFSIZE 65536
+#define FLUX_ARETES 0
+#define MOTS_PAR_PAQUET 64
+#define FLUX_SAUTS 1
+#define FLUX_PERMUTATION 2
+#define TAILLE_SEGMENT_CREUX 4096
+#define SEUIL_CREUX 0.025
+#define AFFOREST_TOURS 2
+#define AFFOREST_ECHANTILLON 1024
+#define TRANCHES_NUMEROTATION 256
+#define LIGNES_PAR_TUILE 8
+#define TAILLE_BLOC_ARENE (1 << 20)
+#define SOMMETS_PAR_TRANCHE 16384
+#define ECART_POINTS 72
+#define ECART_SVG 10
+#define MARGE_SVG 10
+#define LARGEUR_ARETE_SVG 2
+#define RAYON_SVG "\" r=\"2\" fill=\""
+#define BLANC_IMAGE 0xffffff
+#define BLOC_DEFLATE 65535
+#define MODULE_ADLER 65521
+#define TAILLE_TUILE 256
+#define CELLULE_QUOTIENT 16
+#define FORMAT_INSTANTANE 1
+#define LOT_ESSAIS 64
+#define Z_CONFIANCE 1.959963984540054
+#define POINTS_COURBE 100
+#define BANQUE_ECHANTILLONS 100
+#define PAS_PENTE 0.01
+#define MEMOIRE_BANQUE ((int64_t) 1 << 30)
+#define FORMAT_CACHE 1
+#define CAPACITE_CACHE 1024
+#define CACHE_MOYENNE 2
+#define CACHE_PROBA 3
+#define VERSION_TIRAGE 1
 
 
 /*!
@@ -43,6 +93,93 @@ typedef struct {
     liste_t *listes;
 } graphe_t;
 
+/*!
+ * @brief A graph stored in compressed sparse row form.
+ * The neighbors of vertex i are voisins[debuts[i]] ... voisins[debuts[i+1]-1], in increasing order.
+ */
+typedef struct {
+    int nbr_sommets; /**< The number of vertices of the graph. */
+    size_t *debuts; /**< The offsets of each adjacency row, nbr_sommets+1 entries. */
+    int *voisins; /**< The concatenated adjacency rows. */
+} graphe_csr_t;
+
+/*!
+ * @brief The identity of a random draw : the seed of the run and the index of the trial.
+ * Together with the index of an edge, it is the key of the counter-based generator,
+ * so every coin flip can be computed on its own, in any order and on any thread.
+ */
+typedef struct {
+    uint64_t graine; /**< The seed of the run. */
+    uint32_t essai; /**< The index of the trial within the run. */
+} tirage_t;
+
+/*!
+ * @brief Where the sparse sampler stopped in a segment of the edge stream, so that a caller
+ * drawing consecutive ranges, such as the rows of a plane, resumes the walk instead of
+ * starting the segment over. A zeroed cursor is empty.
+ */
+typedef struct {
+    bool actif; /**< Whether the cursor holds a walk. */
+    tirage_t tirage; /**< The draw of the walk. */
+    uint64_t segment; /**< The segment of the walk. */
+    uint64_t bloc; /**< The counter of the next block of random words. */
+    int j; /**< The index of the next random word. */
+    uint32_t alea[4]; /**< The current block of random words. */
+    int64_t position; /**< The next present edge, relative to the segment, TAILLE_SEGMENT_CREUX once past it. */
+    uint64_t couvert; /**< The edges of the stream before this index have been walked over. */
+} curseur_creux_t;
+
+/*!
+ * @brief The connected components labeling engines.
+ * 
+ */
+typedef enum {
+    MOTEUR_DEFAUT, /**< Depth-first search for mode 1, scanline counting for mode 2. */
+    MOTEUR_DFS, /**< Depth-first search over the adjacency lists (exo_coloration_step2). */
+    MOTEUR_UNION_FIND, /**< Union-find over the CSR graph (exo_coloration_union_find). */
+    MOTEUR_PARALLELE, /**< Multithreaded Afforest over the CSR graph (exo_coloration_parallele). */
+    MOTEUR_FUSION, /**< Generation and labeling fused in one multithreaded pass (exo_coloration_fusion). */
+    MOTEUR_FLUX /**< Scanline counting without building the graph, mode 2 only. */
+} moteur_t;
+
+/*!
+ * @brief The output formats of a colored graph.
+ * 
+ */
+typedef enum {
+    RENDU_DOT, /**< Graphviz, laid out by neato (write_graphviz3). */
+    RENDU_POSITIONS, /**< Graphviz with the final positions, for neato -n2 (write_graphviz_positions). */
+    RENDU_SVG, /**< SVG image, without Graphviz (write_svg). */
+    RENDU_PPM, /**< PPM image, one block of pixels per vertex (ecrire_image). */
+    RENDU_PNG, /**< PNG image, one block of pixels per vertex (ecrire_image). */
+    RENDU_TUILES, /**< Pyramid of PNG tiles, one pixel per vertex at the last level (exo_coloration_tuiles). */
+    RENDU_QUOTIENT /**< Graphviz, one node per component, for neato -n2 (exo_coloration_quotient). */
+} rendu_t;
+
+/*!
+ * @brief A grid graph stored as one bit per possible edge.
+ * Bit s of a plane tells whether the edge leaving vertex s in that direction exists,
+ * so the graph costs 2 or 3 bits per vertex and no adjacency list at all.
+ */
+typedef struct {
+    int size; /**< The side of the grid. */
+    bool diagonal; /**< Whether the diagonal plane is used. */
+    int64_t nbr_sommets; /**< The number of vertices, size*size. */
+    uint64_t *horizontales; /**< Bit s : edge between s and s+1. */
+    uint64_t *verticales; /**< Bit s : edge between s and s+size. */
+    uint64_t *diagonales; /**< Bit s : edge between s and s+size+1, NULL without diagonal. */
+} grille_bits_t;
+
+/*!
+ * @brief An iterator over the neighbors of a vertex of a grille_bits_t.
+ * The neighbors are produced in increasing order, like the rows of a graphe_csr_t.
+ */
+typedef struct {
+    const grille_bits_t *grille; /**< The grid being visited. */
+    int64_t sommet; /**< The vertex whose neighbors are listed. */
+    int etape; /**< The next direction to test, from 0 (up-left) to 6 (done). */
+} iterateur_voisins_t;
+
 /*!
  * @brief Definition of a structure representing an edge between two vertices.
  * 
@@ -60,6 +197,19 @@ typedef struct {
     arete_t key; 
 } key_tt;
 
+/*!
+ * @brief A bump allocator made of blocks that are kept between two uses.
+ * Memory is handed out by moving an offset and is only given back all at once by
+ * arene_reinitialiser, in O(1). Once a first trial has grown the blocks, the next trials
+ * of the same size find their memory at the same places and never call malloc.
+ */
+typedef struct {
+    char **blocs; /**< The blocks, as a stb_ds array. */
+    size_t *tailles; /**< The size of each block, as a stb_ds array. */
+    ptrdiff_t bloc; /**< The block being filled. */
+    size_t utilise; /**< The number of bytes used in that block. */
+} arene_t;
+
 /*!
  * @brief Adds a new node to the beginning of a linked list.
  * 
@@ -108,6 +258,79 @@ void detruire_graphe(graphe_t *graphe){
     graphe->nbr_sommets = 0;
 }
 
+/*!
+ * @brief Allocates memory from an arena.
+ * 
+ * @param arene The arena.
+ * @param octets The number of bytes wanted.
+ * @return A pointer aligned on 64 bytes, or NULL if a new block could not be allocated.
+ */
+void *arene_allouer(arene_t *arene, size_t octets) {
+    octets = (octets + 63) & ~(size_t) 63;
+    while (arene->bloc < arrlen(arene->blocs)) {
+        if (arene->utilise + octets <= arene->tailles[arene->bloc]) {
+            void *p = arene->blocs[arene->bloc] + arene->utilise;
+            arene->utilise += octets;
+            return p;
+        }
+        arene->bloc++;
+        arene->utilise = 0;
+    }
+    size_t taille = octets > TAILLE_BLOC_ARENE ? octets : TAILLE_BLOC_ARENE;
+    char *bloc = aligned_alloc(64, taille);
+    if (bloc == NULL) return NULL;
+    arrput(arene->blocs, bloc);
+    arrput(arene->tailles, taille);
+    arene->bloc = arrlen(arene->blocs) - 1;
+    arene->utilise = octets;
+    return bloc;
+}
+
+/*!
+ * @brief Gives back all the memory of an arena at once, keeping its blocks for later.
+ * 
+ * @param arene The arena.
+ */
+void arene_reinitialiser(arene_t *arene) {
+    arene->bloc = 0;
+    arene->utilise = 0;
+}
+
+/*!
+ * @brief Frees the blocks of an arena.
+ * 
+ * @param arene The arena.
+ */
+void arene_detruire(arene_t *arene) {
+    for (ptrdiff_t i = 0; i < arrlen(arene->blocs); i++) free(arene->blocs[i]);
+    arrfree(arene->blocs);
+    arrfree(arene->tailles);
+    arene->bloc = 0;
+    arene->utilise = 0;
+}
+
+/*!
+ * @brief Allocates memory from an arena, or from the heap when arene is NULL.
+ * 
+ * @param arene The arena, or NULL.
+ * @param octets The number of bytes wanted.
+ * @return The memory, or NULL if the allocation failed.
+ */
+void *allouer(arene_t *arene, size_t octets) {
+    if (arene != NULL) return arene_allouer(arene, octets);
+    return malloc(octets > 0 ? octets : 1);
+}
+
+/*!
+ * @brief Frees memory given by allouer; memory from an arena is only given back by arene_reinitialiser.
+ * 
+ * @param arene The arena, or NULL.
+ * @param p The memory.
+ */
+void liberer(arene_t *arene, void *p) {
+    if (arene == NULL) free(p);
+}
+
 /*!
  * @brief Calculates the length of a linked list.
  * @param liste The linked list to calculate the length of.
@@ -208,215 +431,4042 @@ int depiler(struct pile *p) {
 
 
 /*!
- * @brief Writes a graph in Graphviz format to a file.
+ * @brief Gives the number of threads the next parallel region may use.
  * 
- * @param f The file to write the graph to.
- * @param graphe The graph to write.
- * @param couleurs The colors of the nodes.
- * @param pin Whether or not to pin the nodes.
+ * @return The number of threads, 1 without OpenMP.
  */
-void write_graphviz3(FILE *f, graphe_t graphe, int *couleurs, bool pin) {
-    char *pinstr = pin ? "true" : "false";
-    fprintf(f, "graph G {\nlayout = neato   ;\nnode [shape=point, width=.4, colorscheme=X11];\nedge [width=.4, penwidth=4, colorscheme=X11];\n");
+int nombre_threads(void) {
+#ifdef _OPENMP
+    return omp_get_active_level() >= omp_get_max_active_levels() ? 1 : omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
 
-    int size = sqrt(graphe.nbr_sommets);
-    int pos_x, pos_y;
-    for (int i = 0; i < graphe.nbr_sommets; i++) {
-        pos_x = i % size;
-        pos_y = i / size;
-        fprintf(f, "%d [pos=\"%d,%d\", pin=%s, color=%s];\n", i, pos_x, pos_y, pinstr, colornames[couleurs[i]+43]);
-    }
+/*!
+ * @brief Gives the index of the calling thread in its parallel region.
+ * 
+ * @return The index of the thread, 0 without OpenMP.
+ */
+int numero_thread(void) {
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
 
-    chainon_t *chainon;
-    for (int i = 0; i < graphe.nbr_sommets; i++) {
-        chainon = graphe.listes[i];
-        while (chainon != NULL && i < chainon->numero_sommet) {
-            fprintf(f, "%d -- %d [color=%s];\n", i, chainon->numero_sommet, colornames[couleurs[i]+43]);
-            chainon = chainon->next;
-        }
+/*!
+ * @brief A growing output buffer.
+ * 
+ */
+typedef struct {
+    char *octets; /**< The bytes of the buffer. */
+    size_t utilise; /**< The number of bytes in the buffer. */
+    size_t capacite; /**< The size of the buffer. */
+} tampon_sortie_t;
+
+/*!
+ * @brief Appends bytes to a buffer.
+ * 
+ * @param tampon Pointer to the buffer.
+ * @param texte The bytes to append.
+ * @param longueur The number of bytes.
+ * @return false if the buffer could not grow, true otherwise.
+ */
+static inline bool ecrire_tampon(tampon_sortie_t *tampon, const char *texte, size_t longueur) {
+    if (tampon->utilise + longueur > tampon->capacite) {
+        size_t capacite = 2 * tampon->capacite > tampon->utilise + longueur ? 2 * tampon->capacite : tampon->utilise + longueur;
+        if (capacite < BUFSIZE) capacite = BUFSIZE;
+        char *octets = realloc(tampon->octets, capacite);
+        if (octets == NULL) return false;
+        tampon->octets = octets;
+        tampon->capacite = capacite;
     }
+    memcpy(tampon->octets + tampon->utilise, texte, longueur);
+    tampon->utilise += longueur;
+    return true;
+}
 
-    fprintf(f, "}\n");
+/*!
+ * @brief Appends a nonnegative integer in decimal to a buffer, as printf("%d") would.
+ * 
+ * @param tampon Pointer to the buffer.
+ * @param valeur The integer.
+ * @return false if the buffer could not grow, true otherwise.
+ */
+static inline bool ecrire_entier(tampon_sortie_t *tampon, int valeur) {
+    char chiffres[12];
+    int n = sizeof(chiffres);
+    unsigned int v = valeur;
+    do {
+        chiffres[--n] = '0' + v % 10;
+        v /= 10;
+    } while (v != 0);
+    return ecrire_tampon(tampon, chiffres + n, sizeof(chiffres) - n);
 }
 
 /*!
- * @brief Generates a graph with a given size and probability of edges between vertices.
+ * @brief Formats the lines of one section of a file for a range of vertices.
  * 
- * @param size The size of the graph (number of vertices).
- * @param probability The probability of an edge between two vertices being created.
- * @return A graph with the given size and probability of edges.
  */
-graphe_t exo_coloration_step1(int size, double probability, bool diagonal){
-    int matrice[size][size];
-    srand(time(NULL));
-    int comp = 0;
-    for (int i = 0; i < size; i++) {
-        for (int j = 0; j < size; ++j) {
-            matrice[i][j] = comp;
-            comp++;
-        }
-    }
+typedef bool (*formateur_t)(tampon_sortie_t *tampon, const void *contexte, int section, int debut, int fin);
 
-    int matrice_adjacence[size*size][size*size];
-    for (int i = 0; i < size*size; i++) {
-        for (int j = 0; j < size*size; ++j) {
-            matrice_adjacence[i][j] = 0;
+/*!
+ * @brief Writes a file made of sections, each one formatted vertex range by vertex range.
+ * The sections are cut into ranges of SOMMETS_PAR_TRANCHE vertices; each round, the threads
+ * format the next ranges into their own buffers, which are then written in order, so the
+ * file is the same for any number of threads.
+ * 
+ * @param f The file to write to.
+ * @param sections The number of sections.
+ * @param nbr_sommets The number of vertices.
+ * @param formateur The function formatting a range of a section.
+ * @param contexte What the formatter needs.
+ * @return true if the file was written, false if a buffer could not grow.
+ */
+bool ecrire_par_tranches(FILE *f, int sections, int nbr_sommets, formateur_t formateur, const void *contexte) {
+    int tranches = (nbr_sommets + SOMMETS_PAR_TRANCHE - 1) / SOMMETS_PAR_TRANCHE;
+    int par_tour = 2 * nombre_threads();
+    tampon_sortie_t *tampons = calloc(par_tour, sizeof(tampon_sortie_t));
+    if (tampons == NULL) return false;
+    bool valide = true;
+    /* la tranche t est la plage t % tranches de la section t / tranches */
+    for (int premiere = 0; premiere < sections * tranches && valide; premiere += par_tour) {
+        int nombre = sections * tranches - premiere < par_tour ? sections * tranches - premiere : par_tour;
+        #pragma omp parallel for schedule(dynamic, 1) if (nombre > 1) reduction(&&:valide)
+        for (int t = 0; t < nombre; t++) {
+            int tranche = premiere + t;
+            int debut = (tranche % tranches) * SOMMETS_PAR_TRANCHE;
+            int fin = debut + SOMMETS_PAR_TRANCHE < nbr_sommets ? debut + SOMMETS_PAR_TRANCHE : nbr_sommets;
+            tampons[t].utilise = 0;
+            valide = formateur(&tampons[t], contexte, tranche / tranches, debut, fin) && valide;
         }
+        for (int t = 0; t < nombre && valide; t++) valide = fwrite(tampons[t].octets, 1, tampons[t].utilise, f) == tampons[t].utilise;
     }
+    for (int t = 0; t < par_tour; t++) free(tampons[t].octets);
+    free(tampons);
+    return valide;
+}
 
-    for (int i = 0; i < size; i++) {
-        for (int j = 0; j < size; ++j) { 
-            if (i+1 < size) {   
-                if (rand() < probability * ((double)RAND_MAX + 1.0)) {
-                    matrice_adjacence[matrice[i][j]][matrice[i+1][j]] = 1;
-                    matrice_adjacence[matrice[i+1][j]][matrice[i][j]] = 1;
-                }
-            }
-            if (j+1 < size) {
-                if (rand() < probability * ((double)RAND_MAX + 1.0)) {
-                    matrice_adjacence[matrice[i][j]][matrice[i][j+1]] = 1;
-                    matrice_adjacence[matrice[i][j+1]][matrice[i][j]] = 1;
-                }
-            }
-            if (diagonal && j+1 < size && i+1 < size) {
-                if (rand() < probability * ((double)RAND_MAX + 1.0)) {
-                    matrice_adjacence[matrice[i][j]][matrice[i+1][j+1]] = 1;
-                    matrice_adjacence[matrice[i+1][j+1]][matrice[i][j]] = 1;
-                }
-            }
+/*!
+ * @brief What the Graphviz writers look up once: the graph, the pin strings and the color names.
+ * Component c gets the color name c+43, wrapping around the list of names.
+ */
+typedef struct {
+    graphe_t graphe; /**< The graph to write. */
+    const int *couleurs; /**< The colors of the nodes. */
+    int echelle; /**< The distance between two neighbors, in the unit of pos. */
+    const char *pinstr; /**< The text between the position and the color of a node. */
+    size_t longueur_pin; /**< The length of pinstr. */
+    int nbr_noms; /**< The number of color names. */
+    size_t longueurs[sizeof(colornames) / sizeof(colornames[0])]; /**< The length of each color name. */
+} format_dot_t;
+
+/*!
+ * @brief Formats the node lines (section 0) or the edge lines (section 1) of a range of
+ * vertices, each edge written once from its smaller end.
+ * 
+ * @param tampon The buffer to append to.
+ * @param contexte The format_dot_t of the graph.
+ * @param section The section.
+ * @param debut The first vertex.
+ * @param fin The vertex after the last one.
+ * @return false if the buffer could not grow, true otherwise.
+ */
+bool formater_dot(tampon_sortie_t *tampon, const void *contexte, int section, int debut, int fin) {
+    const format_dot_t *format = contexte;
+    graphe_t graphe = format->graphe;
+    int size = sqrt(graphe.nbr_sommets);
+    bool valide = true;
+    for (int i = debut; i < fin && valide; i++) {
+        int nom = (format->couleurs[i] + 43) % format->nbr_noms;
+        if (section == 0) {
+            valide = ecrire_entier(tampon, i)
+                && ecrire_tampon(tampon, " [pos=\"", 7)
+                && ecrire_entier(tampon, i % size * format->echelle)
+                && ecrire_tampon(tampon, ",", 1)
+                && ecrire_entier(tampon, i / size * format->echelle)
+                && ecrire_tampon(tampon, format->pinstr, format->longueur_pin)
+                && ecrire_tampon(tampon, colornames[nom], format->longueurs[nom])
+                && ecrire_tampon(tampon, "];\n", 3);
+            continue;
         }
-    }
-    graphe_t graphe; graphe.nbr_sommets = size*size;
-    graphe.listes = malloc(size*size * sizeof(liste_t));
-    if (graphe.listes == NULL) { graphe.nbr_sommets = 0; return graphe; }
-    for(int i = 0; i < size*size; i++) graphe.listes[i] = NULL;
-    for (int i = 0; i < size*size; i++) {
-        for (int j = 0; j < size*size; ++j) {
-            if (matrice_adjacence[i][j] == 1) {
-                if (ajouter_chainon(j, &graphe.listes[i]) == NULL) {
-                    detruire_graphe(&graphe); return graphe;
-                }
-            }
+        chainon_t *chainon = graphe.listes[i];
+        while (chainon != NULL && i < chainon->numero_sommet && valide) {
+            valide = ecrire_entier(tampon, i)
+                && ecrire_tampon(tampon, " -- ", 4)
+                && ecrire_entier(tampon, chainon->numero_sommet)
+                && ecrire_tampon(tampon, " [color=", 8)
+                && ecrire_tampon(tampon, colornames[nom], format->longueurs[nom])
+                && ecrire_tampon(tampon, "];\n", 3);
+            chainon = chainon->next;
         }
     }
-    return graphe;
+    return valide;
+}
+
+/*!
+ * @brief Prepares the strings of the Graphviz writers.
+ * 
+ * @param format The format to fill.
+ * @param graphe The graph to write.
+ * @param couleurs The colors of the nodes.
+ * @param echelle The distance between two neighbors, in the unit of pos.
+ * @param pinstr The text between the position and the color of a node.
+ */
+void preparer_format_dot(format_dot_t *format, graphe_t graphe, const int *couleurs, int echelle, const char *pinstr) {
+    format->graphe = graphe;
+    format->couleurs = couleurs;
+    format->echelle = echelle;
+    format->pinstr = pinstr;
+    format->longueur_pin = strlen(pinstr);
+    format->nbr_noms = sizeof(colornames) / sizeof(colornames[0]);
+    for (int c = 0; c < format->nbr_noms; c++) format->longueurs[c] = strlen(colornames[c]);
 }
 
+/*!
+ * @brief Writes a graph in Graphviz format to a file.
+ * The lines are formatted by hand, without the parsing cost of fprintf, and in parallel
+ * by ecrire_par_tranches.
+ * 
+ * @param f The file to write the graph to.
+ * @param graphe The graph to write.
+ * @param couleurs The colors of the nodes.
+ * @param pin Whether or not to pin the nodes.
+ * @return false if a buffer could not grow or the file could not be written, true otherwise.
+ */
+bool write_graphviz3(FILE *f, graphe_t graphe, int *couleurs, bool pin) {
+    static const char entete[] = "graph G {\nlayout = neato   ;\nnode [shape=point, width=.4, colorscheme=X11];\nedge [width=.4, penwidth=4, colorscheme=X11];\n";
+    format_dot_t format;
+    preparer_format_dot(&format, graphe, couleurs, 1, pin ? "\", pin=true, color=" : "\", pin=false, color=");
+    return fwrite(entete, 1, sizeof(entete) - 1, f) == sizeof(entete) - 1
+        && ecrire_par_tranches(f, 2, graphe.nbr_sommets, formater_dot, &format) && fwrite("}\n", 1, 2, f) == 2;
+}
 
 /*!
- * @brief This function performs the second step of graph coloring algorithm.
- * It takes a graph and an array of colors as input and returns the number of colors used.
- * The function uses a stack to traverse the graph and assigns colors to each vertex.
- * The algorithm starts by marking all vertices as unvisited and initializes the color to 0.
- * It then iterates over all unvisited vertices and assigns a new color to each connected component.
- * The function returns the number of colors used.
- *
- * @param graphe The graph to be colored
- * @param couleurs The array of colors to be assigned to each vertex
- * @return The number of colors used
+ * @brief Writes a graph in Graphviz format with the final positions of the nodes, in points,
+ * to be drawn by "neato -n2" without any layout.
+ * 
+ * @param f The file to write the graph to.
+ * @param graphe The graph to write.
+ * @param couleurs The colors of the nodes.
+ * @return false if a buffer could not grow or the file could not be written, true otherwise.
  */
-int exo_coloration_step2(graphe_t graphe, int *couleurs){
-    assert(est_symetrique(graphe));
-    bool marquage[graphe.nbr_sommets];
-    memset(marquage, false, sizeof(marquage));
-    int couleur = 0;
-    if (couleurs == NULL) return 0;
-    pile_t pile; pile.taille = graphe.nbr_sommets; pile.sommet = 0;
-    pile.elements = malloc(graphe.nbr_sommets * sizeof(int));
-    for (int i = 0; i < graphe.nbr_sommets; i++) {
-        if (!marquage[i]) {
-            pile.sommet = 0;
-            empiler(&pile, i);
-            couleur = couleur + 1;
-            while (pile.sommet != 0) {
-                int sommet = depiler(&pile);
-                if (!marquage[sommet]) {
-                    marquage[sommet] = true;
-                    couleurs[sommet] = couleur;
-                    chainon_t *chainon = graphe.listes[sommet];
-                    while (chainon != NULL) {
-                        empiler(&pile, chainon->numero_sommet);
-                        chainon = chainon->next;
-                    }
-                }
-            }
+bool write_graphviz_positions(FILE *f, graphe_t graphe, int *couleurs) {
+    static const char entete[] = "graph G {\nsplines=false;\nnode [shape=point, width=.4, colorscheme=X11];\nedge [width=.4, penwidth=4, colorscheme=X11];\n";
+    format_dot_t format;
+    preparer_format_dot(&format, graphe, couleurs, ECART_POINTS, "\", color=");
+    return fwrite(entete, 1, sizeof(entete) - 1, f) == sizeof(entete) - 1
+        && ecrire_par_tranches(f, 2, graphe.nbr_sommets, formater_dot, &format) && fwrite("}\n", 1, 2, f) == 2;
+}
+
+/*!
+ * @brief What the SVG writer looks up once: the graph and the color of each name.
+ * 
+ */
+typedef struct {
+    graphe_t graphe; /**< The graph to write. */
+    const int *couleurs; /**< The colors of the nodes. */
+    int size; /**< The side of the grid. */
+    int nbr_noms; /**< The number of color names. */
+    char hexa[sizeof(colornames) / sizeof(colornames[0])][8]; /**< The "#rrggbb" of each color name. */
+} format_svg_t;
+
+/*!
+ * @brief Formats the edges (section 0) or the nodes (section 1) of a range of vertices in SVG.
+ * The grid is drawn with row 0 at the bottom, as Graphviz does.
+ * 
+ * @param tampon The buffer to append to.
+ * @param contexte The format_svg_t of the graph.
+ * @param section The section.
+ * @param debut The first vertex.
+ * @param fin The vertex after the last one.
+ * @return false if the buffer could not grow, true otherwise.
+ */
+bool formater_svg(tampon_sortie_t *tampon, const void *contexte, int section, int debut, int fin) {
+    const format_svg_t *format = contexte;
+    int size = format->size;
+    bool valide = true;
+    for (int i = debut; i < fin && valide; i++) {
+        const char *couleur = format->hexa[(format->couleurs[i] + 43) % format->nbr_noms];
+        int x = MARGE_SVG + i % size * ECART_SVG, y = MARGE_SVG + (size - 1 - i / size) * ECART_SVG;
+        if (section == 1) {
+            /* les sommets sont dessinés par-dessus les arêtes, dans leur propre groupe */
+            if (i == 0 && !ecrire_tampon(tampon, "</g>\n<g>\n", 9)) return false;
+            valide = ecrire_tampon(tampon, "<circle cx=\"", 12)
+                && ecrire_entier(tampon, x)
+                && ecrire_tampon(tampon, "\" cy=\"", 6)
+                && ecrire_entier(tampon, y)
+                && ecrire_tampon(tampon, RAYON_SVG, sizeof(RAYON_SVG) - 1)
+                && ecrire_tampon(tampon, couleur, 7)
+                && ecrire_tampon(tampon, "\"/>\n", 4);
+            continue;
+        }
+        chainon_t *chainon = format->graphe.listes[i];
+        while (chainon != NULL && i < chainon->numero_sommet && valide) {
+            int v = chainon->numero_sommet;
+            valide = ecrire_tampon(tampon, "<line x1=\"", 10)
+                && ecrire_entier(tampon, x)
+                && ecrire_tampon(tampon, "\" y1=\"", 6)
+                && ecrire_entier(tampon, y)
+                && ecrire_tampon(tampon, "\" x2=\"", 6)
+                && ecrire_entier(tampon, MARGE_SVG + v % size * ECART_SVG)
+                && ecrire_tampon(tampon, "\" y2=\"", 6)
+                && ecrire_entier(tampon, MARGE_SVG + (size - 1 - v / size) * ECART_SVG)
+                && ecrire_tampon(tampon, "\" stroke=\"", 10)
+                && ecrire_tampon(tampon, couleur, 7)
+                && ecrire_tampon(tampon, "\"/>\n", 4);
+            chainon = chainon->next;
         }
     }
-    if (pile.elements != NULL) {
-        free(pile.elements);
-        pile.elements = NULL;
-    }
-    return couleur;
+    return valide;
 }
 
 /*!
- * @brief Calculates the average number of colors used to color a graph of a given size and probability.
+ * @brief Writes a colored grid graph as an SVG image, with the colors of write_graphviz3,
+ * without Graphviz: the positions are known, so the cost is linear in the size of the graph.
  * 
- * @param size The number of vertices in the graph.
- * @param probability The probability of an edge existing between two vertices.
- * @return The average number of colors used to color the graph over 100 iterations.
- */
-double moyenne_couleur(int size, double probability, int k, bool diagonal) {
-    int nbr_couleurs_total = 0;
-    for (int i = 0; i < k; i++) {
-        graphe_t graphe = exo_coloration_step1(size, probability, diagonal);
-        int *couleurs = malloc(graphe.nbr_sommets * sizeof(int));
-        int nbr_couleurs = exo_coloration_step2(graphe, couleurs);
-        nbr_couleurs_total += nbr_couleurs;
-        detruire_graphe(&graphe);
-        free(couleurs);
-    }
-    return (double) nbr_couleurs_total/k;
+ * @param f The file to write the image to.
+ * @param graphe The graph to write.
+ * @param couleurs The colors of the nodes.
+ * @return false if an allocation failed or the file could not be written, true otherwise.
+ */
+bool write_svg(FILE *f, graphe_t graphe, int *couleurs) {
+    format_svg_t *format = malloc(sizeof(format_svg_t));
+    if (format == NULL) return false;
+    format->graphe = graphe;
+    format->couleurs = couleurs;
+    format->size = sqrt(graphe.nbr_sommets);
+    format->nbr_noms = sizeof(colornames) / sizeof(colornames[0]);
+    for (int c = 0; c < format->nbr_noms; c++) snprintf(format->hexa[c], 8, "#%06x", colorvalues[c]);
+    int cote = 2 * MARGE_SVG + (format->size > 0 ? format->size - 1 : 0) * ECART_SVG;
+    bool valide = fprintf(f, "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"%d\" height=\"%d\" viewBox=\"0 0 %d %d\">\n", cote, cote, cote, cote) > 0
+        && fprintf(f, "<rect width=\"100%%\" height=\"100%%\" fill=\"white\"/>\n") > 0
+        && fprintf(f, "<g stroke-width=\"%d\" stroke-linecap=\"round\">\n", LARGEUR_ARETE_SVG) > 0
+        && ecrire_par_tranches(f, 2, graphe.nbr_sommets, formater_svg, format) && fprintf(f, "</g>\n</svg>\n") > 0;
+    free(format);
+    return valide;
 }
 
 /*!
- * @brief Calculates the optimal probability for a given graph size and number of colors.
- * @param size The size of the graph.
- * @param k The number of colors.
- * @return The optimal probability.
- */
-double prob_optimale(int size, int k, bool diagonal) {
-    double proba = 0.5;
-    double proba_min = 0;
-    double proba_max = 1;
-    double moyenne = moyenne_couleur(size, proba, 100, diagonal);
-    while (moyenne > k + 0.0001 || moyenne < k - 0.0001) {
-        if (moyenne < k) {
-            proba_max = proba;
-            proba = (proba + proba_min) / 2;
-        } else {
-            proba_min = proba;
-            proba = (proba + proba_max) / 2;
-        }
-        moyenne = moyenne_couleur(size, proba, 100, diagonal);
+ * @brief Frees the memory allocated for a CSR graph.
+ * 
+ * @param graphe Pointer to the CSR graph to be destroyed.
+ */
+void detruire_graphe_csr(graphe_csr_t *graphe) {
+    free(graphe->debuts);
+    free(graphe->voisins);
+    graphe->debuts = NULL;
+    graphe->voisins = NULL;
+    graphe->nbr_sommets = 0;
+}
+
+/*!
+ * @brief Reads bit s of a bit-plane.
+ * 
+ * @param plan The bit-plane.
+ * @param s The index of the bit.
+ * @return true if the bit is set.
+ */
+static inline bool lire_bit(const uint64_t *plan, int64_t s) {
+    return (plan[s >> 6] >> (s & 63)) & 1;
+}
+
+/*!
+ * @brief Sets bit s of a bit-plane.
+ * 
+ * @param plan The bit-plane.
+ * @param s The index of the bit.
+ */
+static inline void poser_bit(uint64_t *plan, int64_t s) {
+    plan[s >> 6] |= (uint64_t) 1 << (s & 63);
+}
+
+/*!
+ * @brief Frees the memory allocated for the bit-planes of a grid.
+ * 
+ * @param grille Pointer to the grid to be destroyed.
+ */
+void detruire_grille_bits(grille_bits_t *grille) {
+    free(grille->horizontales);
+    free(grille->verticales);
+    free(grille->diagonales);
+    grille->horizontales = NULL;
+    grille->verticales = NULL;
+    grille->diagonales = NULL;
+    grille->nbr_sommets = 0;
+}
+
+/*!
+ * @brief Allocates the zeroed bit-planes of a size*size grid.
+ * 
+ * @param size The side of the grid.
+ * @param diagonal Whether the diagonal plane must be allocated.
+ * @param arene The arena to allocate from, or NULL for the heap (then freed by detruire_grille_bits).
+ * @return The empty grid, with nbr_sommets set to 0 if an allocation failed.
+ */
+grille_bits_t creer_grille_bits(int size, bool diagonal, arene_t *arene) {
+    grille_bits_t grille = {size, diagonal, 0, NULL, NULL, NULL};
+    int64_t n = (int64_t) size * size;
+    size_t mots = (size_t) (n + 63) / 64 + 1;
+    grille.horizontales = allouer(arene, mots * sizeof(uint64_t));
+    grille.verticales = allouer(arene, mots * sizeof(uint64_t));
+    if (diagonal) grille.diagonales = allouer(arene, mots * sizeof(uint64_t));
+    if (grille.horizontales == NULL || grille.verticales == NULL || (diagonal && grille.diagonales == NULL)) {
+        if (arene == NULL) detruire_grille_bits(&grille);
+        grille.nbr_sommets = 0;
+        return grille;
     }
-    return proba;
+    memset(grille.horizontales, 0, mots * sizeof(uint64_t));
+    memset(grille.verticales, 0, mots * sizeof(uint64_t));
+    if (diagonal) memset(grille.diagonales, 0, mots * sizeof(uint64_t));
+    grille.nbr_sommets = n;
+    return grille;
 }
 
-/**
- * @brief Display the help message for the program.
+/*!
+ * @brief The Philox4x32-10 counter-based generator (Salmon et al., SC'11).
+ * Ten rounds of multiply/xor turn a 128-bit counter and a 64-bit key into four
+ * independent 32-bit random words.
  * 
- * Usage: ./prog [type d'éxecution] [taille du carré] [diagonale] [option conditionnelle] ...
+ * @param compteur The 128-bit counter.
+ * @param cle The 64-bit key.
+ * @param sortie Where to store the four random words.
+ */
+static inline void philox4x32(const uint32_t compteur[4], uint64_t cle, uint32_t sortie[4]) {
+    uint32_t c0 = compteur[0], c1 = compteur[1], c2 = compteur[2], c3 = compteur[3];
+    uint32_t k0 = (uint32_t) cle, k1 = (uint32_t) (cle >> 32);
+    for (int tour = 0; tour < 10; tour++) {
+        uint64_t p0 = (uint64_t) 0xD2511F53 * c0;
+        uint64_t p1 = (uint64_t) 0xCD9E8D57 * c2;
+        c0 = (uint32_t) (p1 >> 32) ^ c1 ^ k0;
+        c1 = (uint32_t) p1;
+        c2 = (uint32_t) (p0 >> 32) ^ c3 ^ k1;
+        c3 = (uint32_t) p0;
+        k0 += 0x9E3779B9;
+        k1 += 0xBB67AE85;
+    }
+    sortie[0] = c0; sortie[1] = c1; sortie[2] = c2; sortie[3] = c3;
+}
+
+/*!
+ * @brief Gives the four random words of a block of a stream.
  * 
- * Types d'éxecution :
+ * @param tirage The seed and trial of the draw.
+ * @param flux The stream, so that different uses of the same trial never share words.
+ * @param bloc The index of the block in the stream.
+ * @param sortie Where to store the four random words.
+ */
+static inline void tirer_bloc(tirage_t tirage, uint32_t flux, uint64_t bloc, uint32_t sortie[4]) {
+    uint32_t compteur[4] = {(uint32_t) bloc, (uint32_t) (bloc >> 32), tirage.essai, flux};
+    philox4x32(compteur, tirage.graine, sortie);
+}
+
+/*!
+ * @brief Converts a probability to the integer threshold of a 32-bit random word.
+ * A word w stands for "edge present" when w < seuil, which happens with the given probability.
  * 
- * 1 : Génération d'un graphe aléatoire et coloration:
- *     ./prog 1 [taille grille] [diagonale(true/false)] [probabilité] [ping(true/false)]
+ * @param probability The probability.
+ * @return The threshold, between 0 and 2^32.
+ */
+uint64_t seuil_probabilite(double probability) {
+    if (!(probability > 0)) return 0;
+    if (probability >= 1) return (uint64_t) 1 << 32;
+    return (uint64_t) (probability * 4294967296.0);
+}
+
+/*!
+ * @brief Fills sortie with the random words of nbr_blocs consecutive blocks of a stream.
  * 
- * 2 : Moyenne du nombre de parties connexes pour une taille de grille et une probabilité données
- *     ./prog 2 [taille grille] [diagonale(true/false)] [probabilité]
+ * @param tirage The seed and trial of the draw.
+ * @param flux The stream.
+ * @param bloc The index of the first block.
+ * @param nbr_blocs The number of blocks, a multiple of 16.
+ * @param sortie Where to store the 4*nbr_blocs words, in stream order.
+ */
+static void tirer_blocs_scalaire(tirage_t tirage, uint32_t flux, uint64_t bloc, int nbr_blocs, uint32_t *sortie) {
+    for (int b = 0; b < nbr_blocs; b++) tirer_bloc(tirage, flux, bloc + b, sortie + 4*b);
+}
+
+/*!
+ * @brief Packs the comparisons of 64 random words against a threshold into a word of bits.
  * 
- * 3 : Probabilité optimale pour une taille de grille et un nombre de couleurs donnés
- *     ./prog 3 [taille grille] [diagonale(true/false)] [nombre de couleurs]
+ * @param alea The 64 random words.
+ * @param seuil The threshold, below 2^32.
+ * @return The word whose bit k is set when alea[k] < seuil.
  */
-void display_help(){
-    printf("Usage: ./prog [type d'éxecution] [taille du carré] [diagonale] [option conditionnelle] ...\n");
-    printf("Types d'éxecution :\n");
-    printf("\n1 : Génération d'un graphe aléatoire et coloration:\n");
-    printf("    ./prog 1 [taille grille] [diagonale(true/false)] [probabilité] [ping(true/false)]\n");
-    printf("\n2 : Moyenne du nombre de parties connexes pour une taille de grille et une probabilité données\n");
-    printf("    ./prog 2 [taille grille] [diagonale(true/false)] [probabilité]\n");
-    printf("\n3 : Probabilité optimale pour une taille de grille et un nombre de couleurs donnés\n");
-    printf("    ./prog 3 [taille grille] [diagonale(true/false)] [nombre de couleurs]\n");
+static uint64_t comparer_seuil_scalaire(const uint32_t *alea, uint32_t seuil) {
+    uint64_t mot = 0;
+    for (int k = 0; k < 64; k++) mot |= (uint64_t) (alea[k] < seuil) << k;
+    return mot;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+/*!
+ * @brief One Philox round on eight counters at once (AVX2).
+ * _mm256_mul_epu32 only multiplies the even lanes, so the odd lanes are shifted down
+ * for a second multiplication and both halves are blended back.
+ */
+__attribute__((target("avx2")))
+static inline void philox_tour_avx2(__m256i *c0, __m256i *c1, __m256i *c2, __m256i *c3, __m256i k0, __m256i k1) {
+    const __m256i m0 = _mm256_set1_epi32((int) 0xD2511F53), m1 = _mm256_set1_epi32((int) 0xCD9E8D57);
+    __m256i p0_pair = _mm256_mul_epu32(*c0, m0), p0_impair = _mm256_mul_epu32(_mm256_srli_epi64(*c0, 32), m0);
+    __m256i p1_pair = _mm256_mul_epu32(*c2, m1), p1_impair = _mm256_mul_epu32(_mm256_srli_epi64(*c2, 32), m1);
+    __m256i hi0 = _mm256_blend_epi32(_mm256_srli_epi64(p0_pair, 32), p0_impair, 0xAA);
+    __m256i lo0 = _mm256_blend_epi32(p0_pair, _mm256_slli_epi64(p0_impair, 32), 0xAA);
+    __m256i hi1 = _mm256_blend_epi32(_mm256_srli_epi64(p1_pair, 32), p1_impair, 0xAA);
+    __m256i lo1 = _mm256_blend_epi32(p1_pair, _mm256_slli_epi64(p1_impair, 32), 0xAA);
+    *c0 = _mm256_xor_si256(_mm256_xor_si256(hi1, *c1), k0);
+    *c1 = lo1;
+    *c2 = _mm256_xor_si256(_mm256_xor_si256(hi0, *c3), k1);
+    *c3 = lo0;
+}
+
+/*!
+ * @brief AVX2 version of tirer_blocs_scalaire, eight blocks per iteration.
+ */
+__attribute__((target("avx2")))
+static void tirer_blocs_avx2(tirage_t tirage, uint32_t flux, uint64_t bloc, int nbr_blocs, uint32_t *sortie) {
+    const __m256i rang = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    for (int b = 0; b < nbr_blocs; b += 8) {
+        uint64_t premier = bloc + b;
+        /* retenue vers le mot haut pour les blocs qui dépassent 2^32 */
+        const __m256i biais = _mm256_set1_epi32(INT32_MIN);
+        __m256i base = _mm256_set1_epi32((int) (uint32_t) premier);
+        __m256i c0 = _mm256_add_epi32(base, rang);
+        __m256i retenue = _mm256_cmpgt_epi32(_mm256_xor_si256(base, biais), _mm256_xor_si256(c0, biais));
+        __m256i c1 = _mm256_sub_epi32(_mm256_set1_epi32((int) (uint32_t) (premier >> 32)), retenue);
+        __m256i c2 = _mm256_set1_epi32((int) tirage.essai), c3 = _mm256_set1_epi32((int) flux);
+        uint32_t k0 = (uint32_t) tirage.graine, k1 = (uint32_t) (tirage.graine >> 32);
+        for (int tour = 0; tour < 10; tour++) {
+            philox_tour_avx2(&c0, &c1, &c2, &c3, _mm256_set1_epi32((int) k0), _mm256_set1_epi32((int) k1));
+            k0 += 0x9E3779B9;
+            k1 += 0xBB67AE85;
+        }
+        /* transposition 4x8 : sortie dans l'ordre bloc par bloc */
+        __m256i ab_lo = _mm256_unpacklo_epi32(c0, c1), ab_hi = _mm256_unpackhi_epi32(c0, c1);
+        __m256i cd_lo = _mm256_unpacklo_epi32(c2, c3), cd_hi = _mm256_unpackhi_epi32(c2, c3);
+        __m256i t0 = _mm256_unpacklo_epi64(ab_lo, cd_lo), t1 = _mm256_unpackhi_epi64(ab_lo, cd_lo);
+        __m256i t2 = _mm256_unpacklo_epi64(ab_hi, cd_hi), t3 = _mm256_unpackhi_epi64(ab_hi, cd_hi);
+        __m256i *dest = (__m256i *) (sortie + 4*b);
+        _mm256_storeu_si256(dest, _mm256_permute2x128_si256(t0, t1, 0x20));
+        _mm256_storeu_si256(dest + 1, _mm256_permute2x128_si256(t2, t3, 0x20));
+        _mm256_storeu_si256(dest + 2, _mm256_permute2x128_si256(t0, t1, 0x31));
+        _mm256_storeu_si256(dest + 3, _mm256_permute2x128_si256(t2, t3, 0x31));
+    }
+}
+
+/*!
+ * @brief AVX2 version of comparer_seuil_scalaire, eight comparisons per instruction.
+ * There is no unsigned comparison in AVX2, so both sides are shifted by 2^31.
+ */
+__attribute__((target("avx2")))
+static uint64_t comparer_seuil_avx2(const uint32_t *alea, uint32_t seuil) {
+    const __m256i biais = _mm256_set1_epi32(INT32_MIN);
+    const __m256i s = _mm256_xor_si256(_mm256_set1_epi32((int) seuil), biais);
+    uint64_t mot = 0;
+    for (int k = 0; k < 64; k += 8) {
+        __m256i w = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *) (alea + k)), biais);
+        uint64_t masque = (uint32_t) _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(s, w)));
+        mot |= masque << k;
+    }
+    return mot;
+}
+
+/*!
+ * @brief AVX-512 version of tirer_blocs_scalaire, sixteen blocks per iteration.
+ */
+__attribute__((target("avx512f")))
+static void tirer_blocs_avx512(tirage_t tirage, uint32_t flux, uint64_t bloc, int nbr_blocs, uint32_t *sortie) {
+    const __m512i rang = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m512i m0 = _mm512_set1_epi32((int) 0xD2511F53), m1 = _mm512_set1_epi32((int) 0xCD9E8D57);
+    const __m512i ab_lo_idx = _mm512_setr_epi32(0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23);
+    const __m512i ab_hi_idx = _mm512_setr_epi32(8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31);
+    const __m512i abcd_lo_idx = _mm512_setr_epi64(0, 8, 1, 9, 2, 10, 3, 11);
+    const __m512i abcd_hi_idx = _mm512_setr_epi64(4, 12, 5, 13, 6, 14, 7, 15);
+    for (int b = 0; b < nbr_blocs; b += 16) {
+        uint64_t premier = bloc + b;
+        __m512i c0 = _mm512_add_epi32(_mm512_set1_epi32((int) (uint32_t) premier), rang);
+        __m512i c1 = _mm512_set1_epi32((int) (uint32_t) (premier >> 32));
+        /* retenue vers le mot haut pour les blocs qui dépassent 2^32 */
+        __mmask16 retenue = _mm512_cmplt_epu32_mask(c0, _mm512_set1_epi32((int) (uint32_t) premier));
+        c1 = _mm512_mask_add_epi32(c1, retenue, c1, _mm512_set1_epi32(1));
+        __m512i c2 = _mm512_set1_epi32((int) tirage.essai), c3 = _mm512_set1_epi32((int) flux);
+        uint32_t k0 = (uint32_t) tirage.graine, k1 = (uint32_t) (tirage.graine >> 32);
+        for (int tour = 0; tour < 10; tour++) {
+            __m512i p0_pair = _mm512_mul_epu32(c0, m0), p0_impair = _mm512_mul_epu32(_mm512_srli_epi64(c0, 32), m0);
+            __m512i p1_pair = _mm512_mul_epu32(c2, m1), p1_impair = _mm512_mul_epu32(_mm512_srli_epi64(c2, 32), m1);
+            __m512i hi0 = _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(p0_pair, 32), p0_impair);
+            __m512i lo0 = _mm512_mask_blend_epi32(0xAAAA, p0_pair, _mm512_slli_epi64(p0_impair, 32));
+            __m512i hi1 = _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(p1_pair, 32), p1_impair);
+            __m512i lo1 = _mm512_mask_blend_epi32(0xAAAA, p1_pair, _mm512_slli_epi64(p1_impair, 32));
+            c0 = _mm512_xor_si512(_mm512_xor_si512(hi1, c1), _mm512_set1_epi32((int) k0));
+            c1 = lo1;
+            c2 = _mm512_xor_si512(_mm512_xor_si512(hi0, c3), _mm512_set1_epi32((int) k1));
+            c3 = lo0;
+            k0 += 0x9E3779B9;
+            k1 += 0xBB67AE85;
+        }
+        /* transposition 4x16 : sortie dans l'ordre bloc par bloc */
+        __m512i ab_lo = _mm512_permutex2var_epi32(c0, ab_lo_idx, c1), ab_hi = _mm512_permutex2var_epi32(c0, ab_hi_idx, c1);
+        __m512i cd_lo = _mm512_permutex2var_epi32(c2, ab_lo_idx, c3), cd_hi = _mm512_permutex2var_epi32(c2, ab_hi_idx, c3);
+        uint32_t *dest = sortie + 4*b;
+        _mm512_storeu_si512(dest, _mm512_permutex2var_epi64(ab_lo, abcd_lo_idx, cd_lo));
+        _mm512_storeu_si512(dest + 16, _mm512_permutex2var_epi64(ab_lo, abcd_hi_idx, cd_lo));
+        _mm512_storeu_si512(dest + 32, _mm512_permutex2var_epi64(ab_hi, abcd_lo_idx, cd_hi));
+        _mm512_storeu_si512(dest + 48, _mm512_permutex2var_epi64(ab_hi, abcd_hi_idx, cd_hi));
+    }
+}
+
+/*!
+ * @brief AVX-512 version of comparer_seuil_scalaire, sixteen comparisons per instruction.
+ */
+__attribute__((target("avx512f")))
+static uint64_t comparer_seuil_avx512(const uint32_t *alea, uint32_t seuil) {
+    const __m512i s = _mm512_set1_epi32((int) seuil);
+    uint64_t mot = 0;
+    for (int k = 0; k < 64; k += 16) {
+        __mmask16 masque = _mm512_cmplt_epu32_mask(_mm512_loadu_si512(alea + k), s);
+        mot |= (uint64_t) masque << k;
+    }
+    return mot;
+}
+
+#endif
+
+/*!
+ * @brief The edge sampling kernel : a block generator and a threshold comparison.
+ * 
+ */
+typedef struct {
+    void (*tirer_blocs)(tirage_t, uint32_t, uint64_t, int, uint32_t *); /**< Fills random words, 16 blocks at a time. */
+    uint64_t (*comparer_seuil)(const uint32_t *, uint32_t); /**< Packs 64 comparisons into a word. */
+} noyau_tirage_t;
+
+/*!
+ * @brief Picks the widest edge sampling kernel supported by the processor.
+ * All the kernels produce exactly the same bits.
+ * 
+ * @return The kernel.
+ */
+noyau_tirage_t choisir_noyau_tirage(void) {
+    noyau_tirage_t noyau = {tirer_blocs_scalaire, comparer_seuil_scalaire};
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        noyau.tirer_blocs = tirer_blocs_avx512;
+        noyau.comparer_seuil = comparer_seuil_avx512;
+    } else if (__builtin_cpu_supports("avx2")) {
+        noyau.tirer_blocs = tirer_blocs_avx2;
+        noyau.comparer_seuil = comparer_seuil_avx2;
+    }
+#endif
+    return noyau;
+}
+
+/*!
+ * @brief Draws consecutive edges of the edge stream into a bit array, one random word per edge.
+ * Bit k of dest is set when edge premier+k exists. Edge e uses word e%4 of block e/4,
+ * so the result does not depend on how the range is cut, on the number of threads
+ * or on the kernel chosen by choisir_noyau_tirage.
+ * 
+ * @param tirage The seed and trial of the draw.
+ * @param premier The index of the first edge to draw.
+ * @param nombre The number of edges to draw.
+ * @param seuil The threshold given by seuil_probabilite.
+ * @param dest The bit array, whose words are overwritten.
+ */
+void tirer_aretes_dense(tirage_t tirage, uint64_t premier, int64_t nombre, uint64_t seuil, uint64_t *dest) {
+    int64_t mots = (nombre + 63) / 64;
+    if (seuil == 0 || seuil > UINT32_MAX) {
+        memset(dest, seuil == 0 ? 0 : 0xFF, mots * sizeof(uint64_t));
+    } else {
+        noyau_tirage_t noyau = choisir_noyau_tirage();
+        int64_t paquets = (mots + MOTS_PAR_PAQUET - 1) / MOTS_PAR_PAQUET;
+        #pragma omp parallel for schedule(static) if (paquets > 1)
+        for (int64_t p = 0; p < paquets; p++) {
+            uint32_t alea[64*MOTS_PAR_PAQUET + 64];
+            int64_t premier_mot = p * MOTS_PAR_PAQUET;
+            int nbr_mots = mots - premier_mot < MOTS_PAR_PAQUET ? mots - premier_mot : MOTS_PAR_PAQUET;
+            uint64_t e = premier + premier_mot*64;
+            int decalage = e % 4;
+            int nbr_blocs = (decalage + 64*nbr_mots + 3) / 4;
+            noyau.tirer_blocs(tirage, FLUX_ARETES, e / 4, (nbr_blocs + 15) / 16 * 16, alea);
+            for (int m = 0; m < nbr_mots; m++) {
+                dest[premier_mot + m] = noyau.comparer_seuil(alea + decalage + 64*m, (uint32_t) seuil);
+            }
+        }
+    }
+    if (nombre % 64 != 0) dest[mots-1] &= ((uint64_t) 1 << (nombre % 64)) - 1;
+}
+
+/*!
+ * @brief Moves a sparse cursor to the next present edge of its segment.
+ * The gap to the next present edge follows a geometric law.
+ * 
+ * @param curseur The cursor.
+ * @param inverse_log 1/log(1-p).
+ */
+static inline void avancer_curseur_creux(curseur_creux_t *curseur, double inverse_log) {
+    if (curseur->j % 4 == 0) tirer_bloc(curseur->tirage, FLUX_SAUTS, curseur->bloc++, curseur->alea);
+    double u = ((double) curseur->alea[curseur->j++ % 4] + 1.0) * (1.0 / 4294967296.0);
+    double saut = floor(log(u) * inverse_log);
+    curseur->position = saut >= TAILLE_SEGMENT_CREUX ? TAILLE_SEGMENT_CREUX : curseur->position + (int64_t) saut + 1;
+}
+
+/*!
+ * @brief Sets the present edges of [premier, fin), inside one segment, in a bit array.
+ * The walk goes on from the cursor when it is on the same segment and draw and has not
+ * gone past premier, and starts the segment over otherwise.
+ * 
+ * @param curseur The cursor, updated.
+ * @param tirage The seed and trial of the draw.
+ * @param inverse_log 1/log(1-p).
+ * @param base The index of the edge of bit 0 of dest.
+ * @param premier The first edge to draw.
+ * @param fin The edge after the last one, at most the end of the segment of premier.
+ * @param dest The bit array, whose words are or-ed atomically since neighboring segments
+ * can share a word.
+ */
+void tirer_segment_creux(curseur_creux_t *curseur, tirage_t tirage, double inverse_log, uint64_t base, uint64_t premier, uint64_t fin, uint64_t *dest) {
+    uint64_t segment = premier / TAILLE_SEGMENT_CREUX, debut = segment * TAILLE_SEGMENT_CREUX;
+    if (!curseur->actif || curseur->segment != segment || curseur->tirage.graine != tirage.graine
+        || curseur->tirage.essai != tirage.essai || premier < curseur->couvert) {
+        *curseur = (curseur_creux_t) {true, tirage, segment, segment << 12, 0, {0}, -1, debut};
+        avancer_curseur_creux(curseur, inverse_log);
+    }
+    uint64_t mot = 0, indice_mot = 0;
+    while (curseur->position < TAILLE_SEGMENT_CREUX && debut + curseur->position < fin) {
+        uint64_t e = debut + curseur->position;
+        avancer_curseur_creux(curseur, inverse_log);
+        if (e < premier) continue;
+        uint64_t k = e - base;
+        if (mot != 0 && k >> 6 != indice_mot) {
+            #pragma omp atomic
+            dest[indice_mot] |= mot;
+            mot = 0;
+        }
+        indice_mot = k >> 6;
+        mot |= (uint64_t) 1 << (k & 63);
+    }
+    if (mot != 0) {
+        #pragma omp atomic
+        dest[indice_mot] |= mot;
+    }
+    curseur->couvert = fin;
+}
+
+/*!
+ * @brief Draws consecutive edges of the edge stream by skipping over the missing ones.
+ * The cost is proportional to the number of edges created instead of the number of
+ * candidate edges. The stream is cut into aligned segments of TAILLE_SEGMENT_CREUX edges,
+ * each with its own random words, so the result does not depend on how the range is cut
+ * or on the number of threads. The bits differ from tirer_aretes_dense, but follow the
+ * same law.
+ * 
+ * @param tirage The seed and trial of the draw.
+ * @param premier The index of the first edge to draw.
+ * @param nombre The number of edges to draw.
+ * @param probability The probability of an edge, strictly between 0 and 1.
+ * @param dest The bit array, whose words are overwritten.
+ * @param curseur The cursor of a caller drawing consecutive ranges of the stream on one
+ * thread, or NULL to share the segments of the range between the threads.
+ */
+void tirer_aretes_creux(tirage_t tirage, uint64_t premier, int64_t nombre, double probability, uint64_t *dest, curseur_creux_t *curseur) {
+    int64_t mots = (nombre + 63) / 64;
+    memset(dest, 0, mots * sizeof(uint64_t));
+    double inverse_log = 1.0 / log1p(-probability);
+    uint64_t fin = premier + nombre;
+    if (curseur != NULL) {
+        for (uint64_t e = premier; e < fin; e = (e / TAILLE_SEGMENT_CREUX + 1) * TAILLE_SEGMENT_CREUX) {
+            uint64_t fin_segment = (e / TAILLE_SEGMENT_CREUX + 1) * TAILLE_SEGMENT_CREUX;
+            tirer_segment_creux(curseur, tirage, inverse_log, premier, e, fin < fin_segment ? fin : fin_segment, dest);
+        }
+        return;
+    }
+    uint64_t premier_segment = premier / TAILLE_SEGMENT_CREUX;
+    uint64_t dernier_segment = (fin - 1) / TAILLE_SEGMENT_CREUX;
+    #pragma omp parallel for schedule(dynamic, 16) if (dernier_segment > premier_segment)
+    for (int64_t i = 0; i <= (int64_t) (dernier_segment - premier_segment); i++) {
+        uint64_t debut = (premier_segment + i) * TAILLE_SEGMENT_CREUX;
+        uint64_t fin_segment = debut + TAILLE_SEGMENT_CREUX;
+        curseur_creux_t local = {0};
+        tirer_segment_creux(&local, tirage, inverse_log, premier, debut > premier ? debut : premier, fin < fin_segment ? fin : fin_segment, dest);
+    }
+}
+
+/*!
+ * @brief Draws consecutive edges of the edge stream into a bit array.
+ * Below SEUIL_CREUX the sparse sampler is faster, above it the vectorized one is.
+ * 
+ * @param tirage The seed and trial of the draw.
+ * @param premier The index of the first edge to draw.
+ * @param nombre The number of edges to draw.
+ * @param probability The probability of an edge.
+ * @param dest The bit array, whose words are overwritten.
+ * @param curseur The sparse cursor of a caller drawing consecutive ranges on one thread, such
+ * as the rows of a plane, or NULL. It does not change the bits drawn.
+ */
+void tirer_aretes(tirage_t tirage, uint64_t premier, int64_t nombre, double probability, uint64_t *dest, curseur_creux_t *curseur) {
+    if (nombre <= 0) return;
+    if (probability > 0 && probability < SEUIL_CREUX) tirer_aretes_creux(tirage, premier, nombre, probability, dest, curseur);
+    else tirer_aretes_dense(tirage, premier, nombre, seuil_probabilite(probability), dest);
+}
+
+/*!
+ * @brief Clears the bits of a plane that stand for edges leaving the grid.
+ * 
+ * @param plan The bit-plane.
+ * @param size The side of the grid.
+ * @param colonne Whether the last column must be cleared.
+ * @param ligne Whether the last row must be cleared.
+ */
+void effacer_bords(uint64_t *plan, int size, bool colonne, bool ligne) {
+    int64_t n = (int64_t) size * size;
+    if (colonne) {
+        for (int64_t s = size-1; s < n; s += size) plan[s >> 6] &= ~((uint64_t) 1 << (s & 63));
+    }
+    if (ligne) {
+        for (int64_t s = n - size; s < n; s++) plan[s >> 6] &= ~((uint64_t) 1 << (s & 63));
+    }
+}
+
+/*!
+ * @brief Generates a random grid graph as bit-planes.
+ * Edge s of plane k (0 horizontal, 1 vertical, 2 diagonal) is edge k*size²+s of the
+ * edge stream of the trial, so any edge can be drawn independently of the others.
+ * 
+ * @param size The side of the grid.
+ * @param probability The probability of an edge between two adjacent vertices being created.
+ * @param diagonal Whether the diagonal neighbors can be linked.
+ * @param tirage The seed and trial of the draw.
+ * @param arene The arena to allocate from, or NULL for the heap.
+ * @return The generated grid, with nbr_sommets set to 0 if an allocation failed.
+ */
+grille_bits_t generer_grille_bits(int size, double probability, bool diagonal, tirage_t tirage, arene_t *arene) {
+    grille_bits_t grille = creer_grille_bits(size, diagonal, arene);
+    if (grille.nbr_sommets == 0) return grille;
+    int64_t n = grille.nbr_sommets;
+    tirer_aretes(tirage, 0, n, probability, grille.horizontales, NULL);
+    tirer_aretes(tirage, n, n, probability, grille.verticales, NULL);
+    effacer_bords(grille.horizontales, size, true, false);
+    effacer_bords(grille.verticales, size, false, true);
+    if (diagonal) {
+        tirer_aretes(tirage, 2*n, n, probability, grille.diagonales, NULL);
+        effacer_bords(grille.diagonales, size, true, true);
+    }
+    return grille;
+}
+
+/*!
+ * @brief Starts an iteration over the neighbors of a vertex.
+ * 
+ * @param grille The grid.
+ * @param sommet The vertex whose neighbors are wanted.
+ * @return The iterator, to be passed to voisin_suivant.
+ */
+iterateur_voisins_t premier_voisin(const grille_bits_t *grille, int64_t sommet) {
+    iterateur_voisins_t it = {grille, sommet, 0};
+    return it;
+}
+
+/*!
+ * @brief Gives the next neighbor of an iteration started by premier_voisin.
+ * 
+ * @param it The iterator.
+ * @param voisin Where to store the neighbor.
+ * @return true if a neighbor was found, false when the iteration is over.
+ */
+bool voisin_suivant(iterateur_voisins_t *it, int64_t *voisin) {
+    const grille_bits_t *g = it->grille;
+    int64_t s = it->sommet, size = g->size;
+    bool haut = s >= size, gauche = s % size != 0;
+    while (it->etape < 6) {
+        switch (it->etape++) {
+            case 0:
+                if (g->diagonal && haut && gauche && lire_bit(g->diagonales, s-size-1)) { *voisin = s-size-1; return true; }
+                break;
+            case 1:
+                if (haut && lire_bit(g->verticales, s-size)) { *voisin = s-size; return true; }
+                break;
+            case 2:
+                if (gauche && lire_bit(g->horizontales, s-1)) { *voisin = s-1; return true; }
+                break;
+            case 3:
+                if (lire_bit(g->horizontales, s)) { *voisin = s+1; return true; }
+                break;
+            case 4:
+                if (lire_bit(g->verticales, s)) { *voisin = s+size; return true; }
+                break;
+            case 5:
+                if (g->diagonal && lire_bit(g->diagonales, s)) { *voisin = s+size+1; return true; }
+                break;
+        }
+    }
+    return false;
+}
+
+/*!
+ * @brief Colors the connected components of a bit-plane grid.
+ * The bits are read directly, without building any adjacency list. The colors are
+ * numbered from 1 in increasing order of the smallest vertex of each component,
+ * exactly as exo_coloration_step2 does.
+ * 
+ * @param grille The grid to color.
+ * @param couleurs The array of nbr_sommets colors to fill.
+ * @return The number of colors used, or -1 if the grid has more vertices than an int can label.
+ */
+int64_t colorier_grille_bits(const grille_bits_t *grille, int *couleurs) {
+    if (couleurs == NULL || grille->nbr_sommets > INT32_MAX) return -1;
+    memset(couleurs, 0, grille->nbr_sommets * sizeof(int));
+    int64_t *pile = NULL;
+    int couleur = 0;
+    for (int64_t i = 0; i < grille->nbr_sommets; i++) {
+        if (couleurs[i] != 0) continue;
+        couleur++;
+        couleurs[i] = couleur;
+        arrput(pile, i);
+        while (arrlen(pile) > 0) {
+            int64_t sommet = arrpop(pile), voisin;
+            iterateur_voisins_t it = premier_voisin(grille, sommet);
+            while (voisin_suivant(&it, &voisin)) {
+                if (couleurs[voisin] == 0) {
+                    couleurs[voisin] = couleur;
+                    arrput(pile, voisin);
+                }
+            }
+        }
+    }
+    arrfree(pile);
+    return couleur;
+}
+
+/*!
+ * @brief Converts a bit-plane grid to a CSR graph.
+ * 
+ * @param grille The grid to convert.
+ * @param arene The arena to allocate from, or NULL for the heap (then freed by detruire_graphe_csr).
+ * @return The equivalent CSR graph, with nbr_sommets set to 0 if an allocation failed, the
+ * grid was not generated or it has more vertices than an int can number.
+ */
+graphe_csr_t grille_bits_vers_csr(const grille_bits_t *grille, arene_t *arene) {
+    graphe_csr_t graphe = {0, NULL, NULL};
+    /* une grille dont la génération a échoué n'a pas de plans */
+    if (grille->horizontales == NULL || grille->nbr_sommets != (int64_t) grille->size * grille->size) return graphe;
+    if (grille->nbr_sommets > INT32_MAX) return graphe;
+    int n = grille->nbr_sommets;
+    graphe.debuts = allouer(arene, (n+1) * sizeof(size_t));
+    if (graphe.debuts == NULL) return graphe;
+    /* même ordre que voisin_suivant, mais sans division ni aiguillage par arête */
+    int size = grille->size;
+    const uint64_t *h = grille->horizontales, *v = grille->verticales, *d = grille->diagonales;
+    graphe.debuts[0] = 0;
+    for (int i = 0, s = 0; i < size; i++) {
+        for (int j = 0; j < size; j++, s++) {
+            size_t degre = lire_bit(h, s) + lire_bit(v, s);
+            if (j > 0) degre += lire_bit(h, s-1);
+            if (i > 0) degre += lire_bit(v, s-size);
+            if (d != NULL) {
+                degre += lire_bit(d, s);
+                if (i > 0 && j > 0) degre += lire_bit(d, s-size-1);
+            }
+            graphe.debuts[s+1] = graphe.debuts[s] + degre;
+        }
+    }
+    graphe.voisins = allouer(arene, graphe.debuts[n] * sizeof(int));
+    if (graphe.voisins == NULL) {
+        if (arene == NULL) detruire_graphe_csr(&graphe);
+        return graphe;
+    }
+    for (int i = 0, s = 0; i < size; i++) {
+        for (int j = 0; j < size; j++, s++) {
+            int *w = graphe.voisins + graphe.debuts[s];
+            if (d != NULL && i > 0 && j > 0 && lire_bit(d, s-size-1)) *w++ = s-size-1;
+            if (i > 0 && lire_bit(v, s-size)) *w++ = s-size;
+            if (j > 0 && lire_bit(h, s-1)) *w++ = s-1;
+            if (lire_bit(h, s)) *w++ = s+1;
+            if (lire_bit(v, s)) *w++ = s+size;
+            if (d != NULL && lire_bit(d, s)) *w++ = s+size+1;
+        }
+    }
+    graphe.nbr_sommets = n;
+    return graphe;
+}
+
+/*!
+ * @brief Generates a random grid graph directly in CSR form.
+ * The edges are drawn as bit-planes by generer_grille_bits, then written in CSR
+ * form, so memory and time are O(size²) instead of O(size⁴).
+ * 
+ * @param size The side of the grid.
+ * @param probability The probability of an edge between two adjacent vertices being created.
+ * @param diagonal Whether the diagonal neighbors can be linked.
+ * @param tirage The seed and trial of the draw.
+ * @param arene The arena to allocate from, or NULL for the heap (then freed by detruire_graphe_csr).
+ * @return The generated graph, with nbr_sommets set to 0 if an allocation failed.
+ */
+graphe_csr_t generer_grille_csr(int size, double probability, bool diagonal, tirage_t tirage, arene_t *arene) {
+    grille_bits_t grille = generer_grille_bits(size, probability, diagonal, tirage, arene);
+    graphe_csr_t graphe = grille_bits_vers_csr(&grille, arene);
+    if (arene == NULL) detruire_grille_bits(&grille);
+    return graphe;
+}
+
+/*!
+ * @brief Converts a CSR graph to the linked list representation.
+ * Each list is built in decreasing order of neighbor, as write_graphviz3 expects.
+ * 
+ * With an arena, all the nodes are taken from one array and the graph must not be
+ * passed to detruire_graphe.
+ * 
+ * @param csr The CSR graph to convert.
+ * @param arene The arena to allocate from, or NULL for the heap (then freed by detruire_graphe).
+ * @return The equivalent graphe_t, with nbr_sommets set to 0 if an allocation failed.
+ */
+graphe_t csr_vers_graphe(graphe_csr_t csr, arene_t *arene) {
+    graphe_t graphe; graphe.nbr_sommets = csr.nbr_sommets;
+    graphe.listes = allouer(arene, csr.nbr_sommets * sizeof(liste_t));
+    if (graphe.listes == NULL) { graphe.nbr_sommets = 0; return graphe; }
+    for (int i = 0; i < csr.nbr_sommets; i++) graphe.listes[i] = NULL;
+    if (arene != NULL) {
+        chainon_t *chainons = arene_allouer(arene, csr.debuts[csr.nbr_sommets] * sizeof(chainon_t));
+        if (chainons == NULL) { graphe.nbr_sommets = 0; return graphe; }
+        for (int i = 0; i < csr.nbr_sommets; i++) {
+            for (size_t k = csr.debuts[i]; k < csr.debuts[i+1]; k++) {
+                chainons[k].numero_sommet = csr.voisins[k];
+                chainons[k].next = graphe.listes[i];
+                graphe.listes[i] = &chainons[k];
+            }
+        }
+        return graphe;
+    }
+    for (int i = 0; i < csr.nbr_sommets; i++) {
+        for (size_t k = csr.debuts[i]; k < csr.debuts[i+1]; k++) {
+            if (ajouter_chainon(csr.voisins[k], &graphe.listes[i]) == NULL) {
+                detruire_graphe(&graphe); return graphe;
+            }
+        }
+    }
+    return graphe;
+}
+
+/*!
+ * @brief Generates a graph with a given size and probability of edges between vertices.
+ * 
+ * @param size The size of the graph (number of vertices).
+ * @param probability The probability of an edge between two vertices being created.
+ * @param tirage The seed and trial of the draw.
+ * @return A graph with the given size and probability of edges.
+ */
+graphe_t exo_coloration_step1(int size, double probability, bool diagonal, tirage_t tirage){
+    graphe_csr_t csr = generer_grille_csr(size, probability, diagonal, tirage, NULL);
+    graphe_t graphe = csr_vers_graphe(csr, NULL);
+    detruire_graphe_csr(&csr);
+    return graphe;
+}
+
+
+/*!
+ * @brief Finds the root of x in a union-find forest, halving the path on the way.
+ * 
+ * @param parent The parent of each element.
+ * @param x The element.
+ * @return The root of the set containing x.
+ */
+static inline int uf_trouver(int *parent, int x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+/*!
+ * @brief Merges the sets containing a and b, the shallower tree under the deeper one.
+ * 
+ * @param parent The parent of each element.
+ * @param rang An upper bound of the height of each root.
+ * @param a The first element.
+ * @param b The second element.
+ * @return true if a and b were in different sets, false otherwise.
+ */
+static inline bool uf_unir(int *parent, unsigned char *rang, int a, int b) {
+    a = uf_trouver(parent, a);
+    b = uf_trouver(parent, b);
+    if (a == b) return false;
+    if (rang[a] < rang[b]) { int t = a; a = b; b = t; }
+    parent[b] = a;
+    if (rang[a] == rang[b]) rang[a]++;
+    return true;
+}
+
+int exo_coloration_dfs(graphe_t graphe, int *couleurs, arene_t *arene);
+
+/*!
+ * @brief This function performs the second step of graph coloring algorithm.
+ * It takes a graph and an array of colors as input and returns the number of colors used.
+ * The function uses a stack to traverse the graph and assigns colors to each vertex.
+ * The algorithm starts by marking all vertices as unvisited and initializes the color to 0.
+ * It then iterates over all unvisited vertices and assigns a new color to each connected component.
+ * The function returns the number of colors used.
+ *
+ * @param graphe The graph to be colored
+ * @param couleurs The array of colors to be assigned to each vertex
+ * @return The number of colors used
+ */
+int exo_coloration_step2(graphe_t graphe, int *couleurs){
+    assert(est_symetrique(graphe));
+    return exo_coloration_dfs(graphe, couleurs, NULL);
+}
+
+/*!
+ * @brief The depth-first search of exo_coloration_step2, without the symmetry check,
+ * taking its mark array and stack from an arena.
+ *
+ * @param graphe The graph to be colored
+ * @param couleurs The array of colors to be assigned to each vertex
+ * @param arene The arena to allocate from, or NULL for the heap.
+ * @return The number of colors used
+ */
+int exo_coloration_dfs(graphe_t graphe, int *couleurs, arene_t *arene) {
+    int couleur = 0;
+    if (couleurs == NULL) return 0;
+    bool *marquage = allouer(arene, graphe.nbr_sommets * sizeof(bool));
+    pile_t pile; pile.taille = graphe.nbr_sommets; pile.sommet = 0;
+    pile.elements = allouer(arene, graphe.nbr_sommets * sizeof(int));
+    if (marquage == NULL || pile.elements == NULL) { liberer(arene, marquage); liberer(arene, pile.elements); return 0; }
+    memset(marquage, false, graphe.nbr_sommets * sizeof(bool));
+    /* un sommet est marqué dès qu'il est empilé, la pile ne dépasse donc jamais nbr_sommets */
+    for (int i = 0; i < graphe.nbr_sommets; i++) {
+        if (!marquage[i]) {
+            pile.sommet = 0;
+            marquage[i] = true;
+            empiler(&pile, i);
+            couleur = couleur + 1;
+            while (pile.sommet != 0) {
+                int sommet = depiler(&pile);
+                couleurs[sommet] = couleur;
+                chainon_t *chainon = graphe.listes[sommet];
+                while (chainon != NULL) {
+                    if (!marquage[chainon->numero_sommet]) {
+                        marquage[chainon->numero_sommet] = true;
+                        empiler(&pile, chainon->numero_sommet);
+                    }
+                    chainon = chainon->next;
+                }
+            }
+        }
+    }
+    liberer(arene, pile.elements);
+    liberer(arene, marquage);
+    return couleur;
+}
+
+/*!
+ * @brief Colors the connected components of a CSR graph with a union-find.
+ * The edges are read in memory order, each one once (from its smaller end), and the
+ * colors follow the contract of exo_coloration_step2 : they are numbered from 1 in
+ * increasing order of the smallest vertex of each component.
+ * 
+ * @param graphe The graph to be colored
+ * @param couleurs The array of colors to be assigned to each vertex
+ * @param arene The arena to allocate from, or NULL for the heap.
+ * @return The number of colors used
+ */
+int exo_coloration_union_find(graphe_csr_t graphe, int *couleurs, arene_t *arene) {
+    if (couleurs == NULL) return 0;
+    int n = graphe.nbr_sommets;
+    int *parent = allouer(arene, n * sizeof(int));
+    unsigned char *rang = allouer(arene, n);
+    if (parent == NULL || rang == NULL) { liberer(arene, parent); liberer(arene, rang); return 0; }
+    memset(rang, 0, n);
+    for (int i = 0; i < n; i++) parent[i] = i;
+    for (int i = 0; i < n; i++) {
+        for (size_t k = graphe.debuts[i]; k < graphe.debuts[i+1]; k++) {
+            if (graphe.voisins[k] > i) uf_unir(parent, rang, i, graphe.voisins[k]);
+        }
+    }
+    /* la racine reçoit la couleur de son plus petit sommet, qui est visité en premier */
+    int couleur = 0;
+    memset(couleurs, 0, n * sizeof(int));
+    for (int i = 0; i < n; i++) {
+        int racine = uf_trouver(parent, i);
+        if (couleurs[racine] == 0) couleurs[racine] = ++couleur;
+        couleurs[i] = couleurs[racine];
+    }
+    liberer(arene, parent);
+    liberer(arene, rang);
+    return couleur;
+}
+
+/*!
+ * @brief Links the components of u and v in a concurrent forest (Afforest link).
+ * The larger root is hooked under the smaller one with a compare-and-swap, so every
+ * element always points to a smaller or equal one and the root of a component ends up
+ * being its smallest vertex. Several threads can link at the same time without locks.
+ * 
+ * @param comp The parent of each element, shared by the threads.
+ * @param u The first element.
+ * @param v The second element.
+ */
+static inline void uf_lier_concurrent(int *comp, int u, int v) {
+    int p1 = __atomic_load_n(&comp[u], __ATOMIC_RELAXED);
+    int p2 = __atomic_load_n(&comp[v], __ATOMIC_RELAXED);
+    while (p1 != p2) {
+        int haut = p1 > p2 ? p1 : p2, bas = p1 > p2 ? p2 : p1;
+        int p_haut = __atomic_load_n(&comp[haut], __ATOMIC_RELAXED);
+        if (p_haut == bas) break;
+        if (p_haut == haut && __atomic_compare_exchange_n(&comp[haut], &p_haut, bas, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+        p1 = __atomic_load_n(&comp[__atomic_load_n(&comp[haut], __ATOMIC_RELAXED)], __ATOMIC_RELAXED);
+        p2 = __atomic_load_n(&comp[bas], __ATOMIC_RELAXED);
+    }
+}
+
+/*!
+ * @brief Makes comp[v] point directly to the root of v in a concurrent forest.
+ * 
+ * @param comp The parent of each element, shared by the threads.
+ * @param v The element.
+ */
+static inline void uf_compresser_concurrent(int *comp, int v) {
+    int p = __atomic_load_n(&comp[v], __ATOMIC_RELAXED);
+    int gp = __atomic_load_n(&comp[p], __ATOMIC_RELAXED);
+    while (p != gp) {
+        __atomic_store_n(&comp[v], gp, __ATOMIC_RELAXED);
+        p = gp;
+        gp = __atomic_load_n(&comp[p], __ATOMIC_RELAXED);
+    }
+}
+
+/*!
+ * @brief Compares two integers, for qsort.
+ */
+static int comparer_entiers(const void *a, const void *b) {
+    int x = *(const int *) a, y = *(const int *) b;
+    return (x > y) - (x < y);
+}
+
+/*!
+ * @brief Turns a compressed concurrent forest into colors.
+ * comp[v] must be the root of v, which is the smallest vertex of its component, so the
+ * roots numbered in increasing order give the colors of exo_coloration_step2.
+ * 
+ * @param comp The root of each vertex.
+ * @param n The number of vertices.
+ * @param couleurs The array of colors to fill.
+ * @return The number of colors used.
+ */
+int numeroter_racines(const int *comp, int n, int *couleurs) {
+    int64_t sommes[TRANCHES_NUMEROTATION + 1] = {0};
+    int64_t largeur = ((int64_t) n + TRANCHES_NUMEROTATION - 1) / TRANCHES_NUMEROTATION;
+    #pragma omp parallel for schedule(static)
+    for (int t = 0; t < TRANCHES_NUMEROTATION; t++) {
+        int64_t fin = (t+1) * largeur < n ? (t+1) * largeur : n;
+        for (int64_t v = t * largeur; v < fin; v++) sommes[t+1] += comp[v] == v;
+    }
+    for (int t = 0; t < TRANCHES_NUMEROTATION; t++) sommes[t+1] += sommes[t];
+    #pragma omp parallel for schedule(static)
+    for (int t = 0; t < TRANCHES_NUMEROTATION; t++) {
+        int64_t fin = (t+1) * largeur < n ? (t+1) * largeur : n;
+        int couleur = sommes[t];
+        for (int64_t v = t * largeur; v < fin; v++) if (comp[v] == v) couleurs[v] = ++couleur;
+    }
+    #pragma omp parallel for schedule(static)
+    for (int v = 0; v < n; v++) couleurs[v] = couleurs[comp[v]];
+    return sommes[TRANCHES_NUMEROTATION];
+}
+
+/*!
+ * @brief Colors the connected components of a CSR graph on all cores (Afforest).
+ * The first AFFOREST_TOURS neighbors of every vertex are linked first, which is enough to
+ * build most of the giant component. A sample of vertices then gives the most frequent
+ * component, and its vertices are skipped in the last pass over the remaining edges : their
+ * edges towards other components are seen from the other end. The result is the one of
+ * exo_coloration_step2.
+ * 
+ * @param graphe The graph to be colored
+ * @param couleurs The array of colors to be assigned to each vertex
+ * @param arene The arena to allocate from, or NULL for the heap.
+ * @return The number of colors used
+ */
+int exo_coloration_parallele(graphe_csr_t graphe, int *couleurs, arene_t *arene) {
+    if (couleurs == NULL) return 0;
+    int n = graphe.nbr_sommets;
+    if (n == 0) return 0;
+    int *comp = allouer(arene, n * sizeof(int));
+    if (comp == NULL) return 0;
+    #pragma omp parallel for schedule(static)
+    for (int v = 0; v < n; v++) comp[v] = v;
+
+    for (int tour = 0; tour < AFFOREST_TOURS; tour++) {
+        #pragma omp parallel for schedule(static)
+        for (int v = 0; v < n; v++) {
+            size_t k = graphe.debuts[v] + tour;
+            if (k < graphe.debuts[v+1]) uf_lier_concurrent(comp, v, graphe.voisins[k]);
+        }
+        #pragma omp parallel for schedule(static)
+        for (int v = 0; v < n; v++) uf_compresser_concurrent(comp, v);
+    }
+
+    int echantillon[AFFOREST_ECHANTILLON];
+    for (int k = 0; k < AFFOREST_ECHANTILLON; k++) echantillon[k] = comp[(uint64_t) k * 2654435761u % n];
+    qsort(echantillon, AFFOREST_ECHANTILLON, sizeof(int), comparer_entiers);
+    int geante = echantillon[0], meilleur = 0;
+    for (int k = 0, debut = 0; k <= AFFOREST_ECHANTILLON; k++) {
+        if (k == AFFOREST_ECHANTILLON || echantillon[k] != echantillon[debut]) {
+            if (k - debut > meilleur) { meilleur = k - debut; geante = echantillon[debut]; }
+            debut = k;
+        }
+    }
+
+    #pragma omp parallel for schedule(dynamic, 4096)
+    for (int v = 0; v < n; v++) {
+        if (__atomic_load_n(&comp[v], __ATOMIC_RELAXED) == geante) continue;
+        for (size_t k = graphe.debuts[v] + AFFOREST_TOURS; k < graphe.debuts[v+1]; k++) {
+            uf_lier_concurrent(comp, v, graphe.voisins[k]);
+        }
+    }
+    #pragma omp parallel for schedule(static)
+    for (int v = 0; v < n; v++) uf_compresser_concurrent(comp, v);
+
+    int couleur = numeroter_racines(comp, n, couleurs);
+    liberer(arene, comp);
+    return couleur;
+}
+
+/*!
+ * @brief Generates a random grid and colors its components in a single parallel pass.
+ * Each thread draws the edges of a band of rows and links them at once into a shared
+ * lock-free forest (uf_lier_concurrent), so the graph is never stored and there is no
+ * separate labeling pass. The edges are the ones generer_grille_bits would draw for the
+ * same tirage, and the colors are those of exo_coloration_step2 on that graph.
+ * 
+ * @param size The side of the grid.
+ * @param probability The probability of an edge between two adjacent vertices being created.
+ * @param diagonal Whether the diagonal neighbors can be linked.
+ * @param tirage The seed and trial of the draw.
+ * @param couleurs The array of size*size colors to fill, or NULL to only count the components.
+ * @param arene The arena to allocate from, or NULL for the heap.
+ * @return The number of connected components, or -1 if an allocation failed or the grid has
+ * more vertices than an int can label.
+ */
+int64_t exo_coloration_fusion(int size, double probability, bool diagonal, tirage_t tirage, int *couleurs, arene_t *arene) {
+    int64_t n = (int64_t) size * size;
+    if (n == 0) return 0;
+    /* les parents et les couleurs sont des int */
+    if (n > INT32_MAX) return -1;
+    size_t mots = size / 64 + 1;
+    int threads = nombre_threads();
+    int *comp = allouer(arene, n * sizeof(int));
+    uint64_t *lignes = allouer(arene, 3 * mots * threads * sizeof(uint64_t));
+    if (comp == NULL || lignes == NULL) { liberer(arene, comp); liberer(arene, lignes); return -1; }
+    #pragma omp parallel for schedule(static)
+    for (int64_t v = 0; v < n; v++) comp[v] = v;
+
+    #pragma omp parallel num_threads(threads)
+    {
+        uint64_t *horizontales = lignes + 3 * mots * numero_thread();
+        uint64_t *verticales = horizontales + mots;
+        uint64_t *diagonales = verticales + mots;
+        curseur_creux_t curseurs[3] = {{0}};
+        #pragma omp for schedule(dynamic, LIGNES_PAR_TUILE)
+        for (int i = 0; i < size; i++) {
+            int64_t ligne = (int64_t) i * size;
+            tirer_aretes(tirage, ligne, size, probability, horizontales, &curseurs[0]);
+            for (int j = 0; j+1 < size; j++) {
+                if (lire_bit(horizontales, j)) uf_lier_concurrent(comp, ligne+j, ligne+j+1);
+            }
+            if (i+1 == size) continue;
+            tirer_aretes(tirage, n + ligne, size, probability, verticales, &curseurs[1]);
+            for (int j = 0; j < size; j++) {
+                if (lire_bit(verticales, j)) uf_lier_concurrent(comp, ligne+j, ligne+size+j);
+            }
+            if (!diagonal) continue;
+            tirer_aretes(tirage, 2*n + ligne, size, probability, diagonales, &curseurs[2]);
+            for (int j = 0; j+1 < size; j++) {
+                if (lire_bit(diagonales, j)) uf_lier_concurrent(comp, ligne+j, ligne+size+j+1);
+            }
+        }
+    }
+
+    int64_t composantes = 0;
+    if (couleurs != NULL) {
+        #pragma omp parallel for schedule(static)
+        for (int64_t v = 0; v < n; v++) uf_compresser_concurrent(comp, v);
+        composantes = numeroter_racines(comp, n, couleurs);
+    } else {
+        #pragma omp parallel for schedule(static) reduction(+:composantes)
+        for (int64_t v = 0; v < n; v++) composantes += comp[v] == v;
+    }
+    liberer(arene, comp);
+    liberer(arene, lignes);
+    return composantes;
+}
+
+/*!
+ * @brief Writes a 32-bit integer in big-endian order, as PNG stores them.
+ * 
+ * @param octets Where to write the 4 bytes.
+ * @param valeur The integer.
+ */
+static inline void poser_be32(unsigned char *octets, uint32_t valeur) {
+    octets[0] = valeur >> 24;
+    octets[1] = valeur >> 16;
+    octets[2] = valeur >> 8;
+    octets[3] = valeur;
+}
+
+/*!
+ * @brief Updates the CRC-32 of a PNG chunk.
+ * 
+ * @param crc The CRC of the bytes before, 0 at the start of a chunk.
+ * @param octets The next bytes.
+ * @param longueur The number of bytes.
+ * @return The CRC of all the bytes.
+ */
+uint32_t crc_png(uint32_t crc, const unsigned char *octets, size_t longueur) {
+    static uint32_t table[256];
+    static bool prete = false;
+    if (!__atomic_load_n(&prete, __ATOMIC_ACQUIRE)) {
+        #pragma omp critical(crc_png)
+        if (!prete) {
+            for (uint32_t n = 0; n < 256; n++) {
+                uint32_t c = n;
+                for (int k = 0; k < 8; k++) c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+                table[n] = c;
+            }
+            __atomic_store_n(&prete, true, __ATOMIC_RELEASE);
+        }
+    }
+    crc = ~crc;
+    for (size_t i = 0; i < longueur; i++) crc = table[(crc ^ octets[i]) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+/*!
+ * @brief Updates the Adler-32 checksum that ends a zlib stream.
+ * 
+ * @param adler The checksum of the bytes before, 1 at the start of the stream.
+ * @param octets The next bytes.
+ * @param longueur The number of bytes.
+ * @return The checksum of all the bytes.
+ */
+uint32_t adler_png(uint32_t adler, const unsigned char *octets, size_t longueur) {
+    uint32_t a = adler & 0xffff, b = adler >> 16;
+    while (longueur > 0) {
+        /* 5552 octets au plus avant le modulo, pour que b tienne sur 32 bits */
+        size_t morceau = longueur < 5552 ? longueur : 5552;
+        for (size_t i = 0; i < morceau; i++) {
+            a += octets[i];
+            b += a;
+        }
+        a %= MODULE_ADLER;
+        b %= MODULE_ADLER;
+        octets += morceau;
+        longueur -= morceau;
+    }
+    return b << 16 | a;
+}
+
+/*!
+ * @brief Writes a PNG chunk.
+ * 
+ * @param f The file to write to.
+ * @param type The four letters of the chunk type.
+ * @param donnees The data of the chunk.
+ * @param longueur The length of the data.
+ * @return true if the chunk was written, false otherwise.
+ */
+bool ecrire_chunk_png(FILE *f, const char *type, const unsigned char *donnees, uint32_t longueur) {
+    unsigned char entete[8], fin[4];
+    poser_be32(entete, longueur);
+    memcpy(entete + 4, type, 4);
+    poser_be32(fin, crc_png(crc_png(0, entete + 4, 4), donnees, longueur));
+    return fwrite(entete, 1, 8, f) == 8 && fwrite(donnees, 1, longueur, f) == longueur && fwrite(fin, 1, 4, f) == 4;
+}
+
+/*!
+ * @brief Writes the signature and the header of an 8-bit RGB PNG image, and opens its zlib stream.
+ * 
+ * @param f The file to write to.
+ * @param largeur The width of the image.
+ * @param hauteur The height of the image.
+ * @return true if the beginning of the image was written, false otherwise.
+ */
+bool commencer_png(FILE *f, uint32_t largeur, uint32_t hauteur) {
+    /* en-tête : largeur, hauteur, 8 bits par canal, RGB, sans entrelacement */
+    unsigned char ihdr[13] = {0}, zlib[2] = {0x78, 0x01};
+    poser_be32(ihdr, largeur);
+    poser_be32(ihdr + 4, hauteur);
+    ihdr[8] = 8;
+    ihdr[9] = 2;
+    return fwrite("\x89PNG\r\n\x1a\n", 1, 8, f) == 8 && ecrire_chunk_png(f, "IHDR", ihdr, sizeof(ihdr))
+        && ecrire_chunk_png(f, "IDAT", zlib, sizeof(zlib));
+}
+
+/*!
+ * @brief Closes the zlib stream of a PNG image and ends the file.
+ * 
+ * @param f The file to write to.
+ * @param adler The Adler-32 checksum of the scanlines.
+ * @return true if the end of the image was written, false otherwise.
+ */
+bool terminer_png(FILE *f, uint32_t adler) {
+    /* un bloc final vide ferme le flux deflate, suivi de la somme Adler-32 */
+    unsigned char fin[9] = {1, 0, 0, 0xff, 0xff};
+    poser_be32(fin + 5, adler);
+    return ecrire_chunk_png(f, "IDAT", fin, sizeof(fin)) && ecrire_chunk_png(f, "IEND", NULL, 0);
+}
+
+/*!
+ * @brief Writes one filtered scanline of a PNG image as an IDAT chunk of stored
+ * (uncompressed) deflate blocks. The IDAT chunks of the image together form one zlib
+ * stream, so the scanlines can be written as soon as they are drawn.
+ * 
+ * @param f The file to write to.
+ * @param ligne The scanline, starting with its filter byte.
+ * @param longueur The length of the scanline.
+ * @param adler The Adler-32 checksum of the stream, updated.
+ * @return true if the scanline was written, false otherwise.
+ */
+bool ecrire_ligne_png(FILE *f, const unsigned char *ligne, size_t longueur, uint32_t *adler) {
+    size_t blocs = (longueur + BLOC_DEFLATE - 1) / BLOC_DEFLATE;
+    unsigned char entete[8], bloc[5], fin[4];
+    poser_be32(entete, longueur + 5 * blocs);
+    memcpy(entete + 4, "IDAT", 4);
+    bool valide = fwrite(entete, 1, 8, f) == 8;
+    uint32_t crc = crc_png(0, entete + 4, 4);
+    for (size_t debut = 0; debut < longueur; debut += BLOC_DEFLATE) {
+        uint16_t taille = longueur - debut < BLOC_DEFLATE ? longueur - debut : BLOC_DEFLATE;
+        /* bloc non final, non compressé : sa taille puis son complément, en petit-boutiste */
+        bloc[0] = 0;
+        bloc[1] = taille & 0xff;
+        bloc[2] = taille >> 8;
+        bloc[3] = ~taille & 0xff;
+        bloc[4] = (uint16_t) ~taille >> 8;
+        valide = valide && fwrite(bloc, 1, 5, f) == 5 && fwrite(ligne + debut, 1, taille, f) == taille;
+        crc = crc_png(crc_png(crc, bloc, 5), ligne + debut, taille);
+    }
+    poser_be32(fin, crc);
+    *adler = adler_png(*adler, ligne, longueur);
+    return valide && fwrite(fin, 1, 4, f) == 4;
+}
+
+/*!
+ * @brief Draws one row of pixels of a colored grid.
+ * With blocks of one pixel, each vertex is a pixel of its color. With larger blocks, each
+ * vertex is a square of pixels-1 pixels on a side, followed by a column of pixels showing
+ * the edge to its right neighbor; the first row of the block shows the edges to the row above
+ * (vertical edges, and the diagonal one in its last pixel). Row 0 of the grid is at the
+ * bottom, as in write_svg.
+ * 
+ * @param rgb The 3*size*pixels bytes of the row to fill.
+ * @param grille The bit-planes of the grid, unused with blocks of one pixel.
+ * @param couleurs The colors of the vertices.
+ * @param palette The RGB value of each color name.
+ * @param nbr_noms The number of color names.
+ * @param pixels The side of the block of a vertex.
+ * @param rangee The row of pixels, from the top of the image.
+ */
+void dessiner_rangee(unsigned char *rgb, const grille_bits_t *grille, const int *couleurs, const unsigned int *palette, int nbr_noms, int pixels, int64_t rangee) {
+    int size = grille->size;
+    int64_t i = size - 1 - rangee / pixels;
+    int sous_rangee = rangee % pixels;
+    for (int j = 0; j < size; j++) {
+        int64_t s = i * size + j;
+        unsigned int couleur = palette[(couleurs[s] + 43) % nbr_noms];
+        for (int x = 0; x < pixels; x++) {
+            unsigned int pixel = couleur;
+            if (pixels > 1 && sous_rangee == 0 && x < pixels - 1) pixel = lire_bit(grille->verticales, s) ? couleur : BLANC_IMAGE;
+            else if (pixels > 1 && sous_rangee == 0) pixel = grille->diagonal && lire_bit(grille->diagonales, s) ? couleur : BLANC_IMAGE;
+            else if (pixels > 1 && x == pixels - 1) pixel = lire_bit(grille->horizontales, s) ? couleur : BLANC_IMAGE;
+            unsigned char *p = rgb + 3 * ((int64_t) j * pixels + x);
+            p[0] = pixel >> 16;
+            p[1] = pixel >> 8;
+            p[2] = pixel;
+        }
+    }
+}
+
+/*!
+ * @brief Writes a colored grid as a PPM or PNG image, with the colors of write_graphviz3.
+ * The image is drawn and written one row of pixels at a time, so it needs no more memory
+ * than one row, whatever its size.
+ * 
+ * @param f The file to write the image to.
+ * @param grille The bit-planes of the grid; only size is used with blocks of one pixel.
+ * @param couleurs The colors of the vertices.
+ * @param pixels The side of the block of a vertex, see dessiner_rangee.
+ * @param png Whether to write a PNG image instead of a PPM one.
+ * @return false if the row could not be allocated, the image is too large or the file could
+ * not be written, true otherwise.
+ */
+bool ecrire_image(FILE *f, const grille_bits_t *grille, const int *couleurs, int pixels, bool png) {
+    int64_t cote = (int64_t) grille->size * pixels;
+    if (cote == 0 || cote > INT32_MAX / 3) return false;
+    unsigned char *ligne = malloc(1 + 3 * cote);
+    if (ligne == NULL) return false;
+    int nbr_noms = sizeof(colornames) / sizeof(colornames[0]);
+    if (!png) {
+        bool valide = fprintf(f, "P6\n%lld %lld\n255\n", (long long) cote, (long long) cote) > 0;
+        for (int64_t r = 0; r < cote && valide; r++) {
+            dessiner_rangee(ligne, grille, couleurs, colorvalues, nbr_noms, pixels, r);
+            valide = fwrite(ligne, 1, 3 * cote, f) == (size_t) (3 * cote);
+        }
+        free(ligne);
+        return valide;
+    }
+    bool valide = commencer_png(f, cote, cote);
+    uint32_t adler = 1;
+    ligne[0] = 0;
+    for (int64_t r = 0; r < cote && valide; r++) {
+        dessiner_rangee(ligne + 1, grille, couleurs, colorvalues, nbr_noms, pixels, r);
+        valide = ecrire_ligne_png(f, ligne, 1 + 3 * cote, &adler);
+    }
+    valide = valide && terminer_png(f, adler);
+    free(ligne);
+    return valide;
+}
+
+/*!
+ * @brief Generates a random grid, colors it with the given engine and writes it.
+ * 
+ * @param f The file to write the graph to.
+ * @param size The side of the grid.
+ * @param probability The probability of an edge existing between two vertices.
+ * @param diagonal Whether the diagonal neighbors can be linked.
+ * @param pin Whether or not to pin the nodes.
+ * @param tirage The seed and trial of the draw.
+ * @param moteur The labeling engine, MOTEUR_DEFAUT for the depth-first search.
+ * @param arene The arena to allocate from, or NULL for the heap. The arena is not reset.
+ * @param rendu The output format.
+ * @return The number of colors used, or -1 if an allocation failed or the graph could not be written.
+ */
+int exo_coloration_graphviz(FILE *f, int size, double probability, bool diagonal, bool pin, tirage_t tirage, moteur_t moteur, arene_t *arene, rendu_t rendu) {
+    graphe_csr_t csr = generer_grille_csr(size, probability, diagonal, tirage, arene);
+    if (size > 0 && csr.nbr_sommets == 0) return -1;
+    graphe_t graphe = csr_vers_graphe(csr, arene);
+    int *couleurs = allouer(arene, (graphe.nbr_sommets > 0 ? graphe.nbr_sommets : 1) * sizeof(int));
+    int nbr_couleurs = -1;
+    if (couleurs != NULL && graphe.nbr_sommets == csr.nbr_sommets) {
+        memset(couleurs, 0, graphe.nbr_sommets * sizeof(int));
+        if (moteur == MOTEUR_UNION_FIND) nbr_couleurs = exo_coloration_union_find(csr, couleurs, arene);
+        else if (moteur == MOTEUR_PARALLELE) nbr_couleurs = exo_coloration_parallele(csr, couleurs, arene);
+        else if (moteur == MOTEUR_FUSION) nbr_couleurs = exo_coloration_fusion(size, probability, diagonal, tirage, couleurs, arene);
+        else nbr_couleurs = exo_coloration_step2(graphe, couleurs);
+        bool ecrit;
+        if (rendu == RENDU_SVG) ecrit = write_svg(f, graphe, couleurs);
+        else if (rendu == RENDU_POSITIONS) ecrit = write_graphviz_positions(f, graphe, couleurs);
+        else ecrit = write_graphviz3(f, graphe, couleurs, pin);
+        if (!ecrit) nbr_couleurs = -1;
+    }
+    if (arene == NULL) {
+        detruire_graphe_csr(&csr);
+        detruire_graphe(&graphe);
+    }
+    liberer(arene, couleurs);
+    return nbr_couleurs;
+}
+
+/*!
+ * @brief Generates a random grid and colors it without building any adjacency list:
+ * the grid stays in bit-planes, so the cost is one int per vertex for the colors plus
+ * 2 or 3 bits for the edges.
+ * 
+ * @param size The side of the grid.
+ * @param probability The probability of an edge existing between two vertices.
+ * @param diagonal Whether the diagonal neighbors can be linked.
+ * @param tirage The seed and trial of the draw.
+ * @param moteur The labeling engine: fusion and afforest label on all cores with
+ * exo_coloration_fusion, the others with colorier_grille_bits.
+ * @param grille Where to keep the bit-planes (freed by detruire_grille_bits), or NULL if
+ * the edges are not needed after the labeling.
+ * @param nbr_couleurs Where to store the number of colors used.
+ * @return The size*size colors, to be freed, or NULL if an allocation failed or the grid has
+ * more vertices than an int can label.
+ */
+int *generer_couleurs(int size, double probability, bool diagonal, tirage_t tirage, moteur_t moteur, grille_bits_t *grille, int64_t *nbr_couleurs) {
+    int64_t n = (int64_t) size * size;
+    if (n > INT32_MAX) return NULL;
+    bool fusion = moteur == MOTEUR_FUSION || moteur == MOTEUR_PARALLELE;
+    grille_bits_t bits = {size, diagonal, 0, NULL, NULL, NULL};
+    /* le moteur fusionné n'a besoin des arêtes que si elles sont gardées */
+    if (!fusion || grille != NULL) {
+        bits = generer_grille_bits(size, probability, diagonal, tirage, NULL);
+        if (bits.nbr_sommets == 0) return NULL;
+    }
+    int *couleurs = malloc((n > 0 ? n : 1) * sizeof(int));
+    if (couleurs != NULL) *nbr_couleurs = fusion ? exo_coloration_fusion(size, probability, diagonal, tirage, couleurs, NULL) : colorier_grille_bits(&bits, couleurs);
+    if (couleurs != NULL && *nbr_couleurs < 0) {
+        free(couleurs);
+        couleurs = NULL;
+    }
+    if (grille != NULL && couleurs != NULL) *grille = bits;
+    else detruire_grille_bits(&bits);
+    return couleurs;
+}
+
+/*!
+ * @brief Generates a random grid, colors it and writes it as a PPM or PNG image.
+ * 
+ * @param f The file to write the image to.
+ * @param size The side of the grid.
+ * @param probability The probability of an edge existing between two vertices.
+ * @param diagonal Whether the diagonal neighbors can be linked.
+ * @param tirage The seed and trial of the draw.
+ * @param moteur The labeling engine, see generer_couleurs.
+ * @param pixels The side of the block of a vertex, see dessiner_rangee.
+ * @param png Whether to write a PNG image instead of a PPM one.
+ * @return The number of colors used, or -1 if an allocation failed.
+ */
+int exo_coloration_image(FILE *f, int size, double probability, bool diagonal, tirage_t tirage, moteur_t moteur, int pixels, bool png) {
+    grille_bits_t grille = {size, diagonal, 0, NULL, NULL, NULL};
+    int64_t nbr_couleurs = -1;
+    /* avec un pixel par sommet, les arêtes ne sont pas dessinées */
+    int *couleurs = generer_couleurs(size, probability, diagonal, tirage, moteur, pixels > 1 ? &grille : NULL, &nbr_couleurs);
+    if (couleurs == NULL) return -1;
+    if (!ecrire_image(f, &grille, couleurs, pixels, png)) nbr_couleurs = -1;
+    free(couleurs);
+    detruire_grille_bits(&grille);
+    return nbr_couleurs;
+}
+
+/*!
+ * @brief An entry of the merge table of the tiled export: a vertex that is the smallest of
+ * its component within a band, for the components that reach the edge of their band.
+ * 
+ */
+typedef struct {
+    int64_t key; /**< The vertex. */
+    int64_t value; /**< Its parent in the table, its final root once resolved, then -1 - its color name once drawn. */
+} lien_bande_t;
+
+/*!
+ * @brief A band of TAILLE_TUILE rows of the grid, drawn and labeled on its own.
+ * 
+ */
+typedef struct {
+    int size; /**< The side of the grid. */
+    bool diagonal; /**< Whether the diagonal neighbors can be linked. */
+    double probability; /**< The probability of an edge. */
+    tirage_t tirage; /**< The seed and trial of the draw. */
+    size_t mots; /**< The number of words of a row of bits. */
+    uint64_t *bits; /**< The horizontal, vertical and diagonal bits of the row before the band and of its rows. */
+    int *comp; /**< The smallest vertex of the component of each vertex of the band, within the band. */
+    int *teintes; /**< The color name of each component of the band, indexed by its smallest vertex. */
+} bande_t;
+
+/*!
+ * @brief Draws the rows [debut, fin) of a grid and labels them, as if they were the whole grid.
+ * The edges are drawn from the same streams as generer_grille_bits, so the band is the
+ * same part of the same grid each time it is drawn. The bits of row debut-1 are drawn too,
+ * for the edges that link the band to the one above.
+ * 
+ * @param bande The band.
+ * @param debut The first row of the band.
+ * @param fin The row after the last one.
+ */
+void etiqueter_bande(bande_t *bande, int64_t debut, int64_t fin) {
+    int size = bande->size, hauteur = fin - debut;
+    int64_t n = (int64_t) size * size;
+    size_t mots = bande->mots;
+    int *comp = bande->comp;
+    #pragma omp parallel for schedule(static)
+    for (int v = 0; v < hauteur * size; v++) comp[v] = v;
+    #pragma omp parallel
+    {
+        curseur_creux_t curseurs[3] = {{0}};
+        #pragma omp for schedule(dynamic, LIGNES_PAR_TUILE)
+        for (int r = 0; r <= hauteur; r++) {
+            int64_t i = debut - 1 + r, ligne = i * size;
+            uint64_t *horizontales = bande->bits + 3 * mots * r;
+            uint64_t *verticales = horizontales + mots;
+            uint64_t *diagonales = verticales + mots;
+            if (i < 0) continue;
+            int local = (r - 1) * size;
+            if (r >= 1) {
+                tirer_aretes(bande->tirage, ligne, size, bande->probability, horizontales, &curseurs[0]);
+                for (int j = 0; j+1 < size; j++) {
+                    if (lire_bit(horizontales, j)) uf_lier_concurrent(comp, local+j, local+j+1);
+                }
+            }
+            if (r == hauteur) continue;
+            tirer_aretes(bande->tirage, n + ligne, size, bande->probability, verticales, &curseurs[1]);
+            if (bande->diagonal) tirer_aretes(bande->tirage, 2*n + ligne, size, bande->probability, diagonales, &curseurs[2]);
+            if (r == 0) continue;
+            for (int j = 0; j < size; j++) {
+                if (lire_bit(verticales, j)) uf_lier_concurrent(comp, local+j, local+size+j);
+                if (bande->diagonal && j+1 < size && lire_bit(diagonales, j)) uf_lier_concurrent(comp, local+j, local+size+j+1);
+            }
+        }
+    }
+    #pragma omp parallel for schedule(static)
+    for (int v = 0; v < hauteur * size; v++) uf_compresser_concurrent(comp, v);
+}
+
+/*!
+ * @brief Finds the root of a vertex in the merge table, halving the path on the way.
+ * 
+ * @param liens The merge table, as a stb_ds hash map.
+ * @param sommet A vertex of the table.
+ * @return The smallest vertex of its component so far.
+ */
+int64_t trouver_lien(lien_bande_t *liens, int64_t sommet) {
+    int64_t parent = hmget(liens, sommet);
+    while (parent != sommet) {
+        int64_t grand_parent = hmget(liens, parent);
+        hmput(liens, sommet, grand_parent);
+        sommet = parent;
+        parent = grand_parent;
+    }
+    return sommet;
+}
+
+/*!
+ * @brief Merges two components of the merge table, under the smallest root.
+ * 
+ * @param liens Pointer to the merge table, which may move if b is added.
+ * @param a A vertex of the table.
+ * @param b A vertex, added to the table if it is not in it.
+ */
+void unir_liens(lien_bande_t **liens, int64_t a, int64_t b) {
+    if (hmgeti(*liens, b) < 0) hmput(*liens, b, b);
+    int64_t ra = trouver_lien(*liens, a), rb = trouver_lien(*liens, b);
+    if (ra < rb) hmput(*liens, rb, ra);
+    else if (rb < ra) hmput(*liens, ra, rb);
+}
+
+/*!
+ * @brief Links a labeled band to the band above through the merge table, and records the
+ * components of its last row as the frontier of the next band.
+ * 
+ * @param bande The labeled band.
+ * @param liens Pointer to the merge table.
+ * @param frontiere The root of each vertex of the last row of the band above, replaced by the last row of this band.
+ * @param debut The first row of the band.
+ * @param fin The row after the last one.
+ */
+void relier_bande(const bande_t *bande, lien_bande_t **liens, int64_t *frontiere, int64_t debut, int64_t fin) {
+    int size = bande->size;
+    int64_t base = debut * size;
+    const uint64_t *verticales = bande->bits + bande->mots, *diagonales = verticales + bande->mots;
+    for (int j = 0; j < size && debut > 0; j++) {
+        if (lire_bit(verticales, j)) unir_liens(liens, frontiere[j], base + bande->comp[j]);
+        if (bande->diagonal && j+1 < size && lire_bit(diagonales, j)) unir_liens(liens, frontiere[j], base + bande->comp[j+1]);
+    }
+    const int *derniere = bande->comp + (fin - debut - 1) * size;
+    for (int j = 0; j < size; j++) {
+        frontiere[j] = base + derniere[j];
+        if (hmgeti(*liens, frontiere[j]) < 0) hmput(*liens, frontiere[j], frontiere[j]);
+    }
+}
+
+/*!
+ * @brief Gives a color name to each component of a labeled band, numbering the components
+ * in increasing order of their smallest vertex over the whole grid, as ecrire_image does.
+ * The merge table must have been resolved: a component that leaves the band is numbered
+ * when its final root is met, and the ones merged into it later take its color.
+ * 
+ * @param bande The labeled band.
+ * @param liens The resolved merge table.
+ * @param debut The first row of the band.
+ * @param fin The row after the last one.
+ * @param nbr_couleurs The number of components numbered so far, updated.
+ */
+void colorier_bande(bande_t *bande, lien_bande_t *liens, int64_t debut, int64_t fin, int64_t *nbr_couleurs) {
+    int nbr_noms = sizeof(colornames) / sizeof(colornames[0]);
+    int64_t base = debut * bande->size;
+    for (int v = 0; v < (fin - debut) * bande->size; v++) {
+        if (bande->comp[v] != v) continue;
+        ptrdiff_t e = hmgeti(liens, base + v);
+        int64_t racine = e >= 0 ? liens[e].value : base + v;
+        if (racine == base + v) {
+            bande->teintes[v] = (++*nbr_couleurs + 43) % nbr_noms;
+            if (e >= 0) liens[e].value = -1 - bande->teintes[v];
+        } else {
+            bande->teintes[v] = -1 - hmget(liens, racine);
+        }
+    }
+}
+
+/*!
+ * @brief Writes one TAILLE_TUILE x TAILLE_TUILE tile of a zoom level as a PNG file.
+ * 
+ * @param dossier The directory of the pyramid.
+ * @param niveau The zoom level.
+ * @param x The column of the tile.
+ * @param y The row of the tile.
+ * @param rgb The first pixel of the tile in the row of tiles.
+ * @param pas The length of a row of pixels of the row of tiles, in bytes.
+ * @return false if the file could not be created or written, true otherwise.
+ */
+bool ecrire_tuile(const char *dossier, int niveau, int x, int y, const unsigned char *rgb, size_t pas) {
+    char chemin[4096];
+    snprintf(chemin, sizeof(chemin), "%s/%d/%d/%d.png", dossier, niveau, x, y);
+    FILE *f = fopen(chemin, "wb");
+    if (f == NULL) return false;
+    unsigned char ligne[1 + 3 * TAILLE_TUILE];
+    uint32_t adler = 1;
+    ligne[0] = 0;
+    bool valide = commencer_png(f, TAILLE_TUILE, TAILLE_TUILE);
+    for (int r = 0; r < TAILLE_TUILE && valide; r++) {
+        memcpy(ligne + 1, rgb + r * pas, 3 * TAILLE_TUILE);
+        valide = ecrire_ligne_png(f, ligne, sizeof(ligne), &adler);
+    }
+    valide = valide && terminer_png(f, adler);
+    return fclose(f) == 0 && valide;
+}
+
+/*!
+ * @brief Generates a random grid, colors it and writes it as a pyramid of PNG tiles,
+ * dossier/niveau/x/y.png, with one pixel per vertex at the last level and one tile for the
+ * whole grid at level 0; a pixel of a coarser level is the vertex at its top-left corner.
+ * The colors are those of ecrire_image.
+ * 
+ * Neither the image nor the colors of the grid are ever held in memory: the grid is drawn
+ * twice, one band of TAILLE_TUILE rows at a time. The first pass only records how the
+ * components that reach the edge of a band are merged; the second one colors each band
+ * and fills one row of tiles per level, written as soon as it is complete.
+ * 
+ * @param dossier The directory of the pyramid, created if needed.
+ * @param size The side of the grid.
+ * @param probability The probability of an edge existing between two vertices.
+ * @param diagonal Whether the diagonal neighbors can be linked.
+ * @param tirage The seed and trial of the draw.
+ * @return The number of colors used, or -1 if an allocation or a file failed.
+ */
+int64_t exo_coloration_tuiles(const char *dossier, int size, double probability, bool diagonal, tirage_t tirage) {
+    if (size < 1 || size > INT32_MAX / TAILLE_TUILE) return -1;
+    int niveaux = 0;
+    while (((int64_t) TAILLE_TUILE << niveaux) < size) niveaux++;
+    bande_t bande = {size, diagonal, probability, tirage, size / 64 + 1, NULL, NULL, NULL};
+    bande.bits = malloc(3 * bande.mots * (TAILLE_TUILE + 1) * sizeof(uint64_t));
+    bande.comp = malloc((size_t) TAILLE_TUILE * size * sizeof(int));
+    bande.teintes = malloc((size_t) TAILLE_TUILE * size * sizeof(int));
+    int64_t *frontiere = malloc(size * sizeof(int64_t));
+    /* une rangée de tuiles par niveau, le niveau l réduisant la grille d'un facteur 2^(niveaux-l) */
+    unsigned char **rangees = calloc(niveaux + 1, sizeof(unsigned char *));
+    int *colonnes = calloc(niveaux + 1, sizeof(int));
+    bool valide = bande.bits != NULL && bande.comp != NULL && bande.teintes != NULL && frontiere != NULL && rangees != NULL && colonnes != NULL;
+    char chemin[4096];
+    mkdir(dossier, 0755);
+    for (int l = 0; l <= niveaux && valide; l++) {
+        int64_t cote = (size - 1) / ((int64_t) 1 << (niveaux - l)) + 1;
+        colonnes[l] = (cote + TAILLE_TUILE - 1) / TAILLE_TUILE;
+        rangees[l] = malloc((size_t) 3 * TAILLE_TUILE * TAILLE_TUILE * colonnes[l]);
+        valide = rangees[l] != NULL;
+        if (valide) memset(rangees[l], 0xff, (size_t) 3 * TAILLE_TUILE * TAILLE_TUILE * colonnes[l]);
+        snprintf(chemin, sizeof(chemin), "%s/%d", dossier, l);
+        mkdir(chemin, 0755);
+        for (int x = 0; x < colonnes[l]; x++) {
+            snprintf(chemin, sizeof(chemin), "%s/%d/%d", dossier, l, x);
+            mkdir(chemin, 0755);
+        }
+    }
+
+    /* la rangée de tuiles t couvre les lignes [size - TAILLE_TUILE*(t+1), size - TAILLE_TUILE*t) : la ligne 0 est en bas */
+    int rangees_fines = (size + TAILLE_TUILE - 1) / TAILLE_TUILE;
+    lien_bande_t *liens = NULL;
+    int64_t nbr_couleurs = 0;
+    for (int passe = 0; passe < 2 && valide; passe++) {
+        for (int t = rangees_fines - 1; t >= 0 && valide; t--) {
+            int64_t debut = size - (int64_t) TAILLE_TUILE * (t+1) > 0 ? size - (int64_t) TAILLE_TUILE * (t+1) : 0;
+            int64_t fin = size - (int64_t) TAILLE_TUILE * t;
+            etiqueter_bande(&bande, debut, fin);
+            if (passe == 0) {
+                relier_bande(&bande, &liens, frontiere, debut, fin);
+                continue;
+            }
+            colorier_bande(&bande, liens, debut, fin, &nbr_couleurs);
+            for (int l = 0; l <= niveaux && valide; l++) {
+                int facteur = 1 << (niveaux - l);
+                size_t pas = (size_t) 3 * TAILLE_TUILE * colonnes[l];
+                for (int64_t i = debut; i < fin; i++) {
+                    int64_t rangee = size - 1 - i;
+                    if (rangee % facteur != 0) continue;
+                    unsigned char *p = rangees[l] + (rangee / facteur % TAILLE_TUILE) * pas;
+                    const int *comp = bande.comp + (i - debut) * size;
+                    for (int j = 0; j < size; j += facteur, p += 3) {
+                        unsigned int couleur = colorvalues[bande.teintes[comp[j]]];
+                        p[0] = couleur >> 16;
+                        p[1] = couleur >> 8;
+                        p[2] = couleur;
+                    }
+                }
+                /* la rangée de tuiles t/facteur est complète quand sa ligne du haut est dessinée */
+                if (t % facteur != 0) continue;
+                #pragma omp parallel for schedule(dynamic, 1) reduction(&&:valide)
+                for (int x = 0; x < colonnes[l]; x++) {
+                    valide = ecrire_tuile(dossier, l, x, t / facteur, rangees[l] + 3 * TAILLE_TUILE * x, pas) && valide;
+                }
+                memset(rangees[l], 0xff, pas * TAILLE_TUILE);
+            }
+        }
+        /* entre les deux passes, chaque entrée de la table pointe directement vers sa racine finale */
+        for (ptrdiff_t e = 0; e < hmlen(liens) && passe == 0; e++) liens[e].value = trouver_lien(liens, liens[e].key);
+    }
+
+    hmfree(liens);
+    for (int l = 0; l <= niveaux && rangees != NULL; l++) free(rangees[l]);
+    free(rangees);
+    free(colonnes);
+    free(frontiere);
+    free(bande.bits);
+    free(bande.comp);
+    free(bande.teintes);
+    return valide ? nbr_couleurs : -1;
+}
+
+/*!
+ * @brief Sorts 64-bit keys on their upper 32 bits (LSD radix sort, 8 bits per pass).
+ * The sort is stable, so keys with the same upper half keep their order.
+ * 
+ * @param cles The keys to sort.
+ * @param tampon A work array of the same length.
+ * @param n The number of keys.
+ */
+void trier_radix(uint64_t *cles, uint64_t *tampon, int64_t n) {
+    for (int decalage = 32; decalage < 64; decalage += 8) {
+        int64_t compte[257] = {0};
+        for (int64_t i = 0; i < n; i++) compte[((cles[i] >> decalage) & 0xFF) + 1]++;
+        for (int c = 0; c < 256; c++) compte[c+1] += compte[c];
+        for (int64_t i = 0; i < n; i++) tampon[compte[(cles[i] >> decalage) & 0xFF]++] = cles[i];
+        uint64_t *t = cles;
+        cles = tampon;
+        tampon = t;
+    }
+}
+
+/*!
+ * @brief What the quotient graph keeps of a connected component.
+ * 
+ */
+typedef struct {
+    int64_t sommets; /**< The number of vertices. */
+    int64_t somme_x; /**< The sum of the columns of the vertices. */
+    int64_t somme_y; /**< The sum of the rows of the vertices. */
+    int xmin, xmax; /**< The first and last columns of the bounding box. */
+    int ymin, ymax; /**< The first and last rows of the bounding box. */
+} composante_t;
+
+/*!
+ * @brief Gathers the vertex count, centroid and bounding box of each component, in one pass over the colors.
+ * 
+ * @param couleurs The colors of the size*size vertices, from 1 to nbr_couleurs.
+ * @param size The side of the grid.
+ * @param nbr_couleurs The number of colors.
+ * @return The nbr_couleurs components, component c-1 for color c, to be freed, or NULL if the allocation failed.
+ */
+composante_t *mesurer_composantes(const int *couleurs, int size, int64_t nbr_couleurs) {
+    composante_t *composantes = malloc((nbr_couleurs > 0 ? nbr_couleurs : 1) * sizeof(composante_t));
+    if (composantes == NULL) return NULL;
+    for (int64_t c = 0; c < nbr_couleurs; c++) composantes[c] = (composante_t) {0, 0, 0, size, -1, size, -1};
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            composante_t *c = &composantes[couleurs[(int64_t) y * size + x] - 1];
+            c->sommets++;
+            c->somme_x += x;
+            c->somme_y += y;
+            if (x < c->xmin) c->xmin = x;
+            if (x > c->xmax) c->xmax = x;
+            if (c->ymin == size) c->ymin = y;
+            c->ymax = y;
+        }
+    }
+    return composantes;
+}
+
+/*!
+ * @brief Lists the pairs of components whose bounding boxes touch or overlap, neighbors included.
+ * Two boxes touch when [xmin, xmax+1] x [ymin, ymax+1] of both intersect. The boxes are
+ * registered in the CELLULE_QUOTIENT x CELLULE_QUOTIENT cells they cover, and a pair is only
+ * tested in the cells they share, and kept in the one holding the corner of their intersection.
+ * 
+ * @param composantes The components.
+ * @param nbr_composantes The number of components.
+ * @param size The side of the grid.
+ * @param nbr_paires Where to store the number of pairs.
+ * @return The pairs a<<32|b with a < b, sorted, to be freed, or NULL if an allocation failed.
+ */
+uint64_t *lister_contacts(const composante_t *composantes, int64_t nbr_composantes, int size, int64_t *nbr_paires) {
+    int cote = size / CELLULE_QUOTIENT + 1;
+    int64_t cellules = (int64_t) cote * cote;
+    int64_t *debuts = calloc(cellules + 1, sizeof(int64_t));
+    if (debuts == NULL) return NULL;
+    for (int64_t c = 0; c < nbr_composantes; c++) {
+        const composante_t *b = &composantes[c];
+        for (int cy = b->ymin / CELLULE_QUOTIENT; cy <= (b->ymax + 1) / CELLULE_QUOTIENT; cy++) {
+            for (int cx = b->xmin / CELLULE_QUOTIENT; cx <= (b->xmax + 1) / CELLULE_QUOTIENT; cx++) debuts[(int64_t) cy * cote + cx + 1]++;
+        }
+    }
+    for (int64_t k = 0; k < cellules; k++) debuts[k+1] += debuts[k];
+    int *membres = malloc((debuts[cellules] > 0 ? debuts[cellules] : 1) * sizeof(int));
+    int64_t *remplis = malloc(cellules * sizeof(int64_t));
+    if (membres == NULL || remplis == NULL) {
+        free(debuts);
+        free(membres);
+        free(remplis);
+        return NULL;
+    }
+    memcpy(remplis, debuts, cellules * sizeof(int64_t));
+    for (int64_t c = 0; c < nbr_composantes; c++) {
+        const composante_t *b = &composantes[c];
+        for (int cy = b->ymin / CELLULE_QUOTIENT; cy <= (b->ymax + 1) / CELLULE_QUOTIENT; cy++) {
+            for (int cx = b->xmin / CELLULE_QUOTIENT; cx <= (b->xmax + 1) / CELLULE_QUOTIENT; cx++) membres[remplis[(int64_t) cy * cote + cx]++] = c;
+        }
+    }
+    free(remplis);
+
+    uint64_t *paires = NULL;
+    #pragma omp parallel
+    {
+        uint64_t *locales = NULL;
+        #pragma omp for schedule(dynamic, 64) nowait
+        for (int64_t k = 0; k < cellules; k++) {
+            for (int64_t u = debuts[k]; u < debuts[k+1]; u++) {
+                for (int64_t v = u + 1; v < debuts[k+1]; v++) {
+                    const composante_t *a = &composantes[membres[u]], *b = &composantes[membres[v]];
+                    int x = a->xmin > b->xmin ? a->xmin : b->xmin, y = a->ymin > b->ymin ? a->ymin : b->ymin;
+                    if (x > a->xmax + 1 || x > b->xmax + 1 || y > a->ymax + 1 || y > b->ymax + 1) continue;
+                    if ((int64_t) (y / CELLULE_QUOTIENT) * cote + x / CELLULE_QUOTIENT != k) continue;
+                    uint64_t petit = membres[u] < membres[v] ? membres[u] : membres[v], grand = membres[u] ^ membres[v] ^ petit;
+                    arrput(locales, petit << 32 | grand);
+                }
+            }
+        }
+        #pragma omp critical(contacts)
+        {
+            uint64_t *fin = arraddnptr(paires, arrlen(locales));
+            if (arrlen(locales) > 0) memcpy(fin, locales, arrlen(locales) * sizeof(uint64_t));
+        }
+        arrfree(locales);
+    }
+    free(debuts);
+    free(membres);
+
+    *nbr_paires = arrlen(paires);
+    uint64_t *triees = malloc((*nbr_paires > 0 ? *nbr_paires : 1) * sizeof(uint64_t));
+    uint64_t *tampon = malloc((*nbr_paires > 0 ? *nbr_paires : 1) * sizeof(uint64_t));
+    if (triees != NULL && tampon != NULL) {
+        /* trier_radix ne trie que sur la moitié haute : b puis, le tri étant stable, a */
+        for (int64_t e = 0; e < *nbr_paires; e++) triees[e] = paires[e] << 32 | paires[e] >> 32;
+        trier_radix(triees, tampon, *nbr_paires);
+        for (int64_t e = 0; e < *nbr_paires; e++) triees[e] = triees[e] << 32 | triees[e] >> 32;
+        trier_radix(triees, tampon, *nbr_paires);
+    } else {
+        free(triees);
+        triees = NULL;
+    }
+    free(tampon);
+    arrfree(paires);
+    return triees;
+}
+
+/*!
+ * @brief What the quotient graph writer looks up once.
+ * 
+ */
+typedef struct {
+    const composante_t *composantes; /**< The components. */
+    const uint64_t *paires; /**< The sorted pairs of touching components. */
+    const int64_t *premieres; /**< The first pair of each component, as the smaller one, and the end of the pairs. */
+    int nbr_noms; /**< The number of color names. */
+    size_t longueurs[sizeof(colornames) / sizeof(colornames[0])]; /**< The length of each color name. */
+} format_quotient_t;
+
+/*!
+ * @brief Appends a nonnegative number with two decimals to a buffer.
+ * 
+ * @param tampon Pointer to the buffer.
+ * @param valeur The number.
+ * @return false if the buffer could not grow, true otherwise.
+ */
+static inline bool ecrire_centiemes(tampon_sortie_t *tampon, double valeur) {
+    int64_t centiemes = llround(valeur * 100);
+    char decimales[3] = {'.', '0' + centiemes / 10 % 10, '0' + centiemes % 10};
+    return ecrire_entier(tampon, centiemes / 100) && ecrire_tampon(tampon, decimales, 3);
+}
+
+/*!
+ * @brief Formats the nodes (section 0) or the edges (section 1) of a range of components
+ * of the quotient graph. Node c is component c, drawn at its centroid with a diameter of
+ * sqrt(vertices) grid steps, with its vertex count as label and its bounding box as tooltip.
+ * 
+ * @param tampon The buffer to append to.
+ * @param contexte The format_quotient_t of the graph.
+ * @param section The section.
+ * @param debut The first component, from 0.
+ * @param fin The component after the last one.
+ * @return false if the buffer could not grow, true otherwise.
+ */
+bool formater_quotient(tampon_sortie_t *tampon, const void *contexte, int section, int debut, int fin) {
+    const format_quotient_t *format = contexte;
+    bool valide = true;
+    for (int c = debut; c < fin && valide; c++) {
+        if (section == 1) {
+            for (int64_t e = format->premieres[c]; e < format->premieres[c+1] && valide; e++) {
+                valide = ecrire_entier(tampon, c + 1)
+                    && ecrire_tampon(tampon, " -- ", 4)
+                    && ecrire_entier(tampon, (format->paires[e] & 0xffffffff) + 1)
+                    && ecrire_tampon(tampon, ";\n", 2);
+            }
+            continue;
+        }
+        const composante_t *b = &format->composantes[c];
+        int nom = (c + 1 + 43) % format->nbr_noms;
+        valide = ecrire_entier(tampon, c + 1)
+            && ecrire_tampon(tampon, " [pos=\"", 7)
+            && ecrire_entier(tampon, llround((double) b->somme_x * ECART_POINTS / b->sommets))
+            && ecrire_tampon(tampon, ",", 1)
+            && ecrire_entier(tampon, llround((double) b->somme_y * ECART_POINTS / b->sommets))
+            && ecrire_tampon(tampon, "\", width=", 9)
+            && ecrire_centiemes(tampon, sqrt(b->sommets) * ECART_POINTS / 72)
+            && ecrire_tampon(tampon, ", label=", 8)
+            && ecrire_entier(tampon, b->sommets)
+            && ecrire_tampon(tampon, ", tooltip=\"x ", 13)
+            && ecrire_entier(tampon, b->xmin)
+            && ecrire_tampon(tampon, "..", 2)
+            && ecrire_entier(tampon, b->xmax)
+            && ecrire_tampon(tampon, ", y ", 4)
+            && ecrire_entier(tampon, b->ymin)
+            && ecrire_tampon(tampon, "..", 2)
+            && ecrire_entier(tampon, b->ymax)
+            && ecrire_tampon(tampon, "\", color=", 9)
+            && ecrire_tampon(tampon, colornames[nom], format->longueurs[nom])
+            && ecrire_tampon(tampon, "];\n", 3);
+    }
+    return valide;
+}
+
+/*!
+ * @brief Writes the quotient graph of a colored grid in Graphviz format: one node per
+ * component, placed at its centroid for "neato -n2", and one edge between two components
+ * whose bounding boxes touch. The file grows with the number of components, not with the
+ * number of vertices.
+ * 
+ * @param f The file to write the graph to.
+ * @param couleurs The colors of the size*size vertices, from 1 to nbr_couleurs.
+ * @param size The side of the grid.
+ * @param nbr_couleurs The number of colors.
+ * @return false if an allocation failed, true otherwise.
+ */
+bool write_quotient(FILE *f, const int *couleurs, int size, int64_t nbr_couleurs) {
+    static const char entete[] = "graph G {\nsplines=false;\nnode [shape=circle, style=filled, fixedsize=true, fontsize=10, colorscheme=X11];\nedge [color=gray50];\n";
+    int64_t nbr_paires = 0;
+    bool valide = false;
+    composante_t *composantes = mesurer_composantes(couleurs, size, nbr_couleurs);
+    uint64_t *paires = composantes != NULL ? lister_contacts(composantes, nbr_couleurs, size, &nbr_paires) : NULL;
+    format_quotient_t *format = malloc(sizeof(format_quotient_t));
+    int64_t *premieres = calloc(nbr_couleurs + 1, sizeof(int64_t));
+    if (paires != NULL && format != NULL && premieres != NULL) {
+        for (int64_t e = 0; e < nbr_paires; e++) premieres[(paires[e] >> 32) + 1]++;
+        for (int64_t c = 0; c < nbr_couleurs; c++) premieres[c+1] += premieres[c];
+        *format = (format_quotient_t) {composantes, paires, premieres, sizeof(colornames) / sizeof(colornames[0]), {0}};
+        for (int c = 0; c < format->nbr_noms; c++) format->longueurs[c] = strlen(colornames[c]);
+        valide = fwrite(entete, 1, sizeof(entete) - 1, f) == sizeof(entete) - 1
+            && ecrire_par_tranches(f, 2, nbr_couleurs, formater_quotient, format) && fwrite("}\n", 1, 2, f) == 2;
+    }
+    free(premieres);
+    free(format);
+    free(paires);
+    free(composantes);
+    return valide;
+}
+
+/*!
+ * @brief Generates a random grid, colors it and writes its quotient graph (write_quotient).
+ * 
+ * @param f The file to write the graph to.
+ * @param size The side of the grid.
+ * @param probability The probability of an edge existing between two vertices.
+ * @param diagonal Whether the diagonal neighbors can be linked.
+ * @param tirage The seed and trial of the draw.
+ * @param moteur The labeling engine, see generer_couleurs.
+ * @return The number of colors used, or -1 if an allocation failed.
+ */
+int64_t exo_coloration_quotient(FILE *f, int size, double probability, bool diagonal, tirage_t tirage, moteur_t moteur) {
+    int64_t nbr_couleurs = -1;
+    int *couleurs = generer_couleurs(size, probability, diagonal, tirage, moteur, NULL, &nbr_couleurs);
+    if (couleurs == NULL) return -1;
+    if (!write_quotient(f, couleurs, size, nbr_couleurs)) nbr_couleurs = -1;
+    free(couleurs);
+    return nbr_couleurs;
+}
+
+/*!
+ * @brief The header of a grid snapshot file.
+ * It is followed by the horizontal, vertical and (with diagonals) diagonal bit-planes of
+ * mots words each, then by the nbr_sommets colors as 32-bit integers, all in the byte order
+ * of the machine that wrote the file.
+ */
+typedef struct {
+    char magie[8]; /**< "TPGRILL" and a zero byte. */
+    uint32_t format; /**< The version of the file format. */
+    uint32_t version; /**< VERSION_TIRAGE when the grid was drawn. */
+    int32_t size; /**< The side of the grid. */
+    uint32_t diagonal; /**< 1 if the diagonal plane is stored, 0 otherwise. */
+    double probabilite; /**< The probability of an edge. */
+    uint64_t graine; /**< The seed of the draw. */
+    uint64_t essai; /**< The trial of the draw. */
+    int64_t nbr_sommets; /**< The number of vertices, size*size. */
+    int64_t nbr_couleurs; /**< The number of colors. */
+    uint64_t mots; /**< The number of words of a bit-plane. */
+} entete_instantane_t;
+
+/*!
+ * @brief A grid snapshot mapped in memory: the grid and its colors point into the file,
+ * which is mapped read-only, so nothing is copied and they must not be written to.
+ * 
+ */
+typedef struct {
+    int fd; /**< The file descriptor, -1 when closed. */
+    size_t taille; /**< The size of the mapping. */
+    const entete_instantane_t *entete; /**< The mapped file, NULL when closed. */
+    grille_bits_t grille; /**< The bit-planes of the grid. */
+    const int *couleurs; /**< The colors of the vertices. */
+} instantane_t;
+
+/*!
+ * @brief Gives the size of a snapshot file from its header.
+ * 
+ * @param entete The header.
+ * @return The size of the file, in bytes, or 0 if it does not fit in a size_t.
+ */
+size_t taille_instantane(const entete_instantane_t *entete) {
+    size_t plans, couleurs, taille;
+    if (entete->nbr_sommets < 0
+        || __builtin_mul_overflow(entete->mots, (entete->diagonal ? 3 : 2) * sizeof(uint64_t), &plans)
+        || __builtin_mul_overflow((uint64_t) entete->nbr_sommets, sizeof(int32_t), &couleurs)
+        || __builtin_add_overflow(plans, couleurs, &taille)
+        || __builtin_add_overflow(taille, sizeof(entete_instantane_t), &taille)) return 0;
+    return taille;
+}
+
+/*!
+ * @brief Writes a colored grid and the parameters of its draw to a snapshot file.
+ * 
+ * @param chemin The path of the file, replaced if it exists.
+ * @param grille The bit-planes of the grid.
+ * @param couleurs The colors of the vertices.
+ * @param nbr_couleurs The number of colors.
+ * @param probability The probability the grid was drawn with.
+ * @param tirage The seed and trial the grid was drawn with.
+ * @return true if the file was written, false otherwise.
+ */
+bool ecrire_instantane(const char *chemin, const grille_bits_t *grille, const int *couleurs, int64_t nbr_couleurs, double probability, tirage_t tirage) {
+    FILE *f = fopen(chemin, "wb");
+    if (f == NULL) return false;
+    int64_t n = grille->nbr_sommets;
+    entete_instantane_t entete = {"TPGRILL", FORMAT_INSTANTANE, VERSION_TIRAGE, grille->size, grille->diagonal, probability, tirage.graine, tirage.essai, n, nbr_couleurs, (uint64_t) (n + 63) / 64 + 1};
+    bool valide = fwrite(&entete, sizeof(entete), 1, f) == 1;
+    valide = valide && fwrite(grille->horizontales, sizeof(uint64_t), entete.mots, f) == entete.mots;
+    valide = valide && fwrite(grille->verticales, sizeof(uint64_t), entete.mots, f) == entete.mots;
+    if (grille->diagonal) valide = valide && fwrite(grille->diagonales, sizeof(uint64_t), entete.mots, f) == entete.mots;
+    valide = valide && fwrite(couleurs, sizeof(int), n, f) == (size_t) n;
+    return fclose(f) == 0 && valide;
+}
+
+/*!
+ * @brief Tells whether a bit-plane has a bit set past its last vertex.
+ * 
+ * @param plan The bit-plane.
+ * @param n The number of vertices.
+ * @param mots The number of words of the plane.
+ * @return true if a bit of index n or more is set.
+ */
+bool bits_apres_grille(const uint64_t *plan, int64_t n, uint64_t mots) {
+    uint64_t premier = (uint64_t) n >> 6;
+    if (premier < mots && (plan[premier] >> (n & 63)) != 0) return true;
+    for (uint64_t m = premier + 1; m < mots; m++) {
+        if (plan[m] != 0) return true;
+    }
+    return false;
+}
+
+/*!
+ * @brief Unmaps a snapshot and closes its file.
+ * 
+ * @param instantane Pointer to the snapshot.
+ */
+void fermer_instantane(instantane_t *instantane) {
+    if (instantane->entete != NULL) munmap((void *) instantane->entete, instantane->taille);
+    if (instantane->fd >= 0) close(instantane->fd);
+    instantane->entete = NULL;
+    instantane->fd = -1;
+}
+
+/*!
+ * @brief Maps a snapshot file in memory, without reading it: the pages of the grid and of
+ * the colors are only loaded when they are used.
+ * 
+ * @param instantane The snapshot to fill.
+ * @param chemin The path of the file.
+ * @return true if the file is a valid snapshot, false otherwise.
+ */
+bool ouvrir_instantane(instantane_t *instantane, const char *chemin) {
+    instantane->entete = NULL;
+    instantane->taille = 0;
+    instantane->fd = open(chemin, O_RDONLY);
+    if (instantane->fd < 0) return false;
+    struct stat infos;
+    bool valide = fstat(instantane->fd, &infos) == 0 && (size_t) infos.st_size >= sizeof(entete_instantane_t);
+    if (valide) {
+        void *projection = mmap(NULL, infos.st_size, PROT_READ, MAP_SHARED, instantane->fd, 0);
+        valide = projection != MAP_FAILED;
+        if (valide) {
+            instantane->entete = projection;
+            instantane->taille = infos.st_size;
+        }
+    }
+    const entete_instantane_t *entete = instantane->entete;
+    /* les couleurs sont des int indexés par int : la grille doit en tenir autant que colorier_grille_bits */
+    valide = valide && memcmp(entete->magie, "TPGRILL", 8) == 0 && entete->format == FORMAT_INSTANTANE
+        && entete->size >= 1 && entete->diagonal <= 1 && entete->nbr_sommets == (int64_t) entete->size * entete->size
+        && entete->nbr_sommets <= INT32_MAX && entete->nbr_couleurs >= 0 && entete->nbr_couleurs <= entete->nbr_sommets
+        && entete->mots == (uint64_t) (entete->nbr_sommets + 63) / 64 + 1 && taille_instantane(entete) == (size_t) infos.st_size;
+    if (valide) {
+        uint64_t *plans = (uint64_t *) (entete + 1);
+        instantane->grille = (grille_bits_t) {entete->size, entete->diagonal, entete->nbr_sommets, plans, plans + entete->mots, entete->diagonal ? plans + 2 * entete->mots : NULL};
+        instantane->couleurs = (const int *) (plans + (entete->diagonal ? 3 : 2) * entete->mots);
+        /* une couleur hors de [1, nbr_couleurs], ou une arête sortant de la grille (bords effacés
+           comme le fait generer_grille_bits), ferait lire les écrivains hors de leurs tableaux */
+        const grille_bits_t *grille = &instantane->grille;
+        int64_t n = entete->nbr_sommets, size = entete->size, hors_bornes = 0;
+        #pragma omp parallel for schedule(static) reduction(+:hors_bornes)
+        for (int64_t v = 0; v < n; v++) {
+            bool colonne = v % size == size - 1, ligne = v >= n - size;
+            hors_bornes += instantane->couleurs[v] < 1 || instantane->couleurs[v] > entete->nbr_couleurs
+                || (colonne && lire_bit(grille->horizontales, v)) || (ligne && lire_bit(grille->verticales, v))
+                || (grille->diagonal && (colonne || ligne) && lire_bit(grille->diagonales, v));
+        }
+        valide = hors_bornes == 0 && !bits_apres_grille(grille->horizontales, n, entete->mots)
+            && !bits_apres_grille(grille->verticales, n, entete->mots)
+            && !(grille->diagonal && bits_apres_grille(grille->diagonales, n, entete->mots));
+    }
+    if (!valide) fermer_instantane(instantane);
+    return valide;
+}
+
+/*!
+ * @brief Writes an already colored grid in one of the output formats of mode 1.
+ * 
+ * @param f The file to write to.
+ * @param grille The bit-planes of the grid.
+ * @param couleurs The colors of the vertices.
+ * @param nbr_couleurs The number of colors.
+ * @param rendu The output format, anything but RENDU_TUILES.
+ * @param pin Whether or not to pin the nodes, for RENDU_DOT.
+ * @param pixels The side of the block of a vertex, for RENDU_PPM and RENDU_PNG.
+ * @return false if an allocation failed or the format needs to draw the grid, true otherwise.
+ */
+bool rendre_grille(FILE *f, const grille_bits_t *grille, const int *couleurs, int64_t nbr_couleurs, rendu_t rendu, bool pin, int pixels) {
+    if (rendu == RENDU_TUILES) return false;
+    if (rendu == RENDU_PPM || rendu == RENDU_PNG) return ecrire_image(f, grille, couleurs, pixels, rendu == RENDU_PNG);
+    if (rendu == RENDU_QUOTIENT) return write_quotient(f, couleurs, grille->size, nbr_couleurs);
+    graphe_csr_t csr = grille_bits_vers_csr(grille, NULL);
+    graphe_t graphe = csr_vers_graphe(csr, NULL);
+    bool valide = csr.nbr_sommets == grille->nbr_sommets && graphe.nbr_sommets == csr.nbr_sommets;
+    /* les écrivains Graphviz et SVG ne modifient pas les couleurs */
+    if (valide && rendu == RENDU_SVG) valide = write_svg(f, graphe, (int *) couleurs);
+    else if (valide && rendu == RENDU_POSITIONS) valide = write_graphviz_positions(f, graphe, (int *) couleurs);
+    else if (valide) valide = write_graphviz3(f, graphe, (int *) couleurs, pin);
+    detruire_graphe_csr(&csr);
+    detruire_graphe(&graphe);
+    return valide;
+}
+
+/*!
+ * @brief Generates a random grid, colors it, saves it as a snapshot and writes it in one of
+ * the output formats of mode 1, from the same data as a later reload of the snapshot.
+ * 
+ * @param chemin The path of the snapshot file.
+ * @param f The file to write the graph to.
+ * @param size The side of the grid.
+ * @param probability The probability of an edge existing between two vertices.
+ * @param diagonal Whether the diagonal neighbors can be linked.
+ * @param pin Whether or not to pin the nodes.
+ * @param tirage The seed and trial of the draw.
+ * @param moteur The labeling engine, see generer_couleurs.
+ * @param rendu The output format, anything but RENDU_TUILES.
+ * @param pixels The side of the block of a vertex in images.
+ * @return The number of colors used, or -1 if an allocation or the snapshot failed.
+ */
+int64_t exo_coloration_instantane(const char *chemin, FILE *f, int size, double probability, bool diagonal, bool pin, tirage_t tirage, moteur_t moteur, rendu_t rendu, int pixels) {
+    grille_bits_t grille;
+    int64_t nbr_couleurs = -1;
+    int *couleurs = generer_couleurs(size, probability, diagonal, tirage, moteur, &grille, &nbr_couleurs);
+    if (couleurs == NULL) return -1;
+    if (!ecrire_instantane(chemin, &grille, couleurs, nbr_couleurs, probability, tirage) || !rendre_grille(f, &grille, couleurs, nbr_couleurs, rendu, pin, pixels)) nbr_couleurs = -1;
+    free(couleurs);
+    detruire_grille_bits(&grille);
+    return nbr_couleurs;
+}
+
+/*!
+ * @brief The O(size) workspace of the scanline engine.
+ * Only two rows of the grid are alive at any time : the previous one in slots
+ * [0, size) and the current one in slots [size, 2*size).
+ */
+typedef struct {
+    int size; /**< The side of the grid. */
+    int *parent; /**< The union-find parents of the 2*size slots. */
+    unsigned char *rang; /**< The union-find ranks of the 2*size slots. */
+    int *renumero; /**< The new slot of each root when the current row becomes the previous one, -1 otherwise. */
+    int *racines; /**< The root of each slot of the current row. */
+    uint64_t *horizontales; /**< The horizontal edges of the current row. */
+    uint64_t *verticales; /**< The edges between the previous row and the current one. */
+    uint64_t *diagonales; /**< The diagonal edges between the previous row and the current one. */
+} flux_t;
+
+/*!
+ * @brief Frees the workspace of the scanline engine.
+ * 
+ * @param flux Pointer to the workspace.
+ */
+void detruire_flux(flux_t *flux) {
+    free(flux->parent); free(flux->rang); free(flux->renumero); free(flux->racines);
+    free(flux->horizontales); free(flux->verticales); free(flux->diagonales);
+    memset(flux, 0, sizeof(flux_t));
+}
+
+/*!
+ * @brief Allocates the workspace of the scanline engine for a size*size grid.
+ * 
+ * @param size The side of the grid.
+ * @return The workspace, with size set to 0 if an allocation failed.
+ */
+flux_t creer_flux(int size) {
+    flux_t flux;
+    size_t mots = size / 64 + 1;
+    flux.size = size;
+    flux.parent = malloc(2 * (size_t) size * sizeof(int) + 1);
+    flux.rang = malloc(2 * (size_t) size + 1);
+    flux.renumero = malloc(2 * (size_t) size * sizeof(int) + 1);
+    flux.racines = malloc((size_t) size * sizeof(int) + 1);
+    flux.horizontales = malloc(mots * sizeof(uint64_t));
+    flux.verticales = malloc(mots * sizeof(uint64_t));
+    flux.diagonales = malloc(mots * sizeof(uint64_t));
+    if (flux.parent == NULL || flux.rang == NULL || flux.renumero == NULL || flux.racines == NULL
+        || flux.horizontales == NULL || flux.verticales == NULL || flux.diagonales == NULL) {
+        detruire_flux(&flux);
+        return flux;
+    }
+    for (int j = 0; j < 2*size; j++) flux.renumero[j] = -1;
+    return flux;
+}
+
+/*!
+ * @brief Counts the connected components of a random grid without building it.
+ * The grid is generated one row at a time and a Hoshen-Kopelman union-find runs over the
+ * previous row and the current one : every vertex adds a component and every union of two
+ * different sets removes one. The edges are the ones generer_grille_bits would draw for
+ * the same tirage, so the count is the one colorier_grille_bits would give, with O(size)
+ * memory instead of O(size²).
+ * 
+ * @param flux The workspace, allocated by creer_flux for this size.
+ * @param probability The probability of an edge between two adjacent vertices being created.
+ * @param diagonal Whether the diagonal neighbors can be linked.
+ * @param tirage The seed and trial of the draw.
+ * @return The number of connected components.
+ */
+int64_t compter_composantes_flux(flux_t *flux, double probability, bool diagonal, tirage_t tirage) {
+    int size = flux->size;
+    int64_t n = (int64_t) size * size;
+    int *parent = flux->parent, *renumero = flux->renumero, *racines = flux->racines;
+    unsigned char *rang = flux->rang;
+    int64_t composantes = 0;
+    curseur_creux_t curseurs[3] = {{0}};
+    for (int i = 0; i < size; i++) {
+        int64_t ligne = (int64_t) i * size;
+        for (int j = 0; j < size; j++) { parent[size+j] = size+j; rang[size+j] = 0; }
+        composantes += size;
+
+        tirer_aretes(tirage, ligne, size, probability, flux->horizontales, &curseurs[0]);
+        for (int j = 0; j+1 < size; j++) {
+            if (lire_bit(flux->horizontales, j) && uf_unir(parent, rang, size+j, size+j+1)) composantes--;
+        }
+        if (i > 0) {
+            tirer_aretes(tirage, n + ligne - size, size, probability, flux->verticales, &curseurs[1]);
+            for (int j = 0; j < size; j++) {
+                if (lire_bit(flux->verticales, j) && uf_unir(parent, rang, j, size+j)) composantes--;
+            }
+            if (diagonal) {
+                tirer_aretes(tirage, 2*n + ligne - size, size, probability, flux->diagonales, &curseurs[2]);
+                for (int j = 0; j+1 < size; j++) {
+                    if (lire_bit(flux->diagonales, j) && uf_unir(parent, rang, j, size+j+1)) composantes--;
+                }
+            }
+        }
+
+        /* la ligne courante devient la ligne précédente, avec des arbres de hauteur 1 */
+        for (int j = 0; j < size; j++) {
+            int racine = uf_trouver(parent, size+j);
+            racines[j] = racine;
+            if (renumero[racine] == -1) renumero[racine] = j;
+        }
+        for (int j = 0; j < size; j++) {
+            parent[j] = renumero[racines[j]];
+            rang[j] = parent[j] == j;
+        }
+        for (int j = 0; j < size; j++) renumero[racines[j]] = -1;
+    }
+    return composantes;
+}
+
+/*!
+ * @brief Everything a worker needs to run trials of one grid size without allocating.
+ * The graphs, labels and stacks of a trial live in the arena, which is reset in O(1)
+ * before the next trial; the scanline workspace is simply reused.
+ */
+typedef struct {
+    int size; /**< The side of the grids. */
+    arene_t arene; /**< The storage of the graph, labels and stacks of the current trial. */
+    flux_t flux; /**< The workspace of the scanline engine. */
+} contexte_essai_t;
+
+/*!
+ * @brief Creates the trial context of a worker.
+ * 
+ * @param size The side of the grids.
+ * @return The context, with flux.parent set to NULL if an allocation failed.
+ */
+contexte_essai_t creer_contexte_essai(int size) {
+    contexte_essai_t contexte;
+    contexte.size = size;
+    memset(&contexte.arene, 0, sizeof(arene_t));
+    contexte.flux = creer_flux(size);
+    return contexte;
+}
+
+/*!
+ * @brief Frees a trial context.
+ * 
+ * @param contexte Pointer to the context.
+ */
+void detruire_contexte_essai(contexte_essai_t *contexte) {
+    arene_detruire(&contexte->arene);
+    detruire_flux(&contexte->flux);
+}
+
+/*!
+ * @brief Counts the components of one random grid with the given engine.
+ * 
+ * @param moteur The labeling engine; MOTEUR_DEFAUT uses the scanline engine.
+ * @param contexte The trial context of the calling worker.
+ * @param probability The probability of an edge existing between two vertices.
+ * @param diagonal Whether the diagonal neighbors can be linked.
+ * @param tirage The seed and trial of the draw.
+ * @return The number of connected components, or -1 if an allocation failed.
+ */
+int64_t compter_composantes(moteur_t moteur, contexte_essai_t *contexte, double probability, bool diagonal, tirage_t tirage) {
+    if (moteur == MOTEUR_DEFAUT || moteur == MOTEUR_FLUX) return compter_composantes_flux(&contexte->flux, probability, diagonal, tirage);
+    arene_t *arene = &contexte->arene;
+    arene_reinitialiser(arene);
+    if (moteur == MOTEUR_FUSION) return exo_coloration_fusion(contexte->size, probability, diagonal, tirage, NULL, arene);
+    graphe_csr_t csr = generer_grille_csr(contexte->size, probability, diagonal, tirage, arene);
+    int *couleurs = arene_allouer(arene, csr.nbr_sommets * sizeof(int));
+    if (couleurs == NULL || (contexte->size > 0 && csr.nbr_sommets == 0)) return -1;
+    if (moteur == MOTEUR_UNION_FIND) return exo_coloration_union_find(csr, couleurs, arene);
+    if (moteur == MOTEUR_PARALLELE) return exo_coloration_parallele(csr, couleurs, arene);
+    graphe_t graphe = csr_vers_graphe(csr, arene);
+    return exo_coloration_dfs(graphe, couleurs, arene);
+}
+
+/*!
+ * @brief The running mean and variance of a series of trials (Welford's algorithm).
+ *
+ */
+typedef struct {
+    int64_t essais; /**< The number of trials. */
+    double moyenne; /**< The mean of the trials. */
+    double m2; /**< The sum of the squared deviations from the mean. */
+} statistiques_t;
+
+/*!
+ * @brief Adds one trial to the statistics.
+ *
+ * @param stats Pointer to the statistics.
+ * @param valeur The result of the trial.
+ */
+void statistiques_ajouter(statistiques_t *stats, double valeur) {
+    stats->essais++;
+    double ecart = valeur - stats->moyenne;
+    stats->moyenne += ecart / stats->essais;
+    stats->m2 += ecart * (valeur - stats->moyenne);
+}
+
+/*!
+ * @brief Calculates the standard error of the mean.
+ *
+ * @param stats Pointer to the statistics.
+ * @return The standard error, or INFINITY with less than two trials.
+ */
+double statistiques_erreur_type(const statistiques_t *stats) {
+    if (stats->essais < 2) return INFINITY;
+    return sqrt(stats->m2 / (stats->essais - 1) / stats->essais);
+}
+
+/*!
+ * @brief Calculates the half-width of the 95% confidence interval of the mean.
+ *
+ * @param stats Pointer to the statistics.
+ * @return The half-width of the interval.
+ */
+double statistiques_demi_largeur(const statistiques_t *stats) {
+    return Z_CONFIANCE * statistiques_erreur_type(stats);
+}
+
+/*!
+ * @brief The header of a result cache file, followed by a hash table of capacite entries.
+ * 
+ */
+typedef struct {
+    char magie[8]; /**< "TPCACHE" and a zero byte. */
+    uint32_t format; /**< The version of the file format. */
+    uint32_t reserve; /**< Unused, kept at zero. */
+    uint64_t capacite; /**< The number of slots of the table, a power of two. */
+    uint64_t nbr_entrees; /**< The number of used slots. */
+} entete_cache_t;
+
+/*!
+ * @brief An entry of the result cache: the parameters of a run, then its result.
+ * The slot is free when essais is 0.
+ */
+typedef struct {
+    uint32_t type; /**< CACHE_MOYENNE or CACHE_PROBA. */
+    uint32_t version; /**< VERSION_TIRAGE when the entry was computed. */
+    int32_t size; /**< The side of the grid. */
+    uint32_t diagonal; /**< Whether the diagonal neighbors can be linked. */
+    double parametre; /**< The probability (CACHE_MOYENNE) or the number of components (CACHE_PROBA). */
+    uint64_t graine; /**< The seed of the run. */
+    int64_t essais; /**< The number of trials or samples used. */
+    double valeur; /**< The average number of components or the optimal probability. */
+    double dispersion; /**< The sum of the squared deviations, or the uncertainty of the probability. */
+} entree_cache_t;
+
+/*!
+ * @brief A result cache file mapped in memory. Every access holds an exclusive lock on the
+ * file, so several processes can share it.
+ */
+typedef struct {
+    int fd; /**< The file descriptor, -1 when the cache is closed. */
+    size_t taille; /**< The size of the mapping. */
+    entete_cache_t *entete; /**< The mapped file. */
+} cache_t;
+
+/*!
+ * @brief Gives the entries of a mapped cache.
+ * 
+ * @param cache Pointer to the cache.
+ * @return The first slot of the table.
+ */
+static inline entree_cache_t *entrees_cache(const cache_t *cache) {
+    return (entree_cache_t *) (cache->entete + 1);
+}
+
+/*!
+ * @brief Hashes the parameters of an entry (FNV-1a).
+ * 
+ * @param entree The entry.
+ * @return The hash.
+ */
+uint64_t hacher_entree(const entree_cache_t *entree) {
+    uint64_t champs[6] = {entree->type, entree->version, (uint64_t) entree->size, entree->diagonal, 0, entree->graine};
+    memcpy(&champs[4], &entree->parametre, sizeof(double));
+    uint64_t h = 14695981039346656037ULL;
+    const unsigned char *octets = (const unsigned char *) champs;
+    for (size_t i = 0; i < sizeof(champs); i++) h = (h ^ octets[i]) * 1099511628211ULL;
+    return h;
+}
+
+/*!
+ * @brief Checks whether two entries have the same parameters.
+ * 
+ * @param a The first entry.
+ * @param b The second entry.
+ * @return true if the parameters are the same, false otherwise.
+ */
+bool memes_parametres(const entree_cache_t *a, const entree_cache_t *b) {
+    return a->type == b->type && a->version == b->version && a->size == b->size && a->diagonal == b->diagonal
+        && a->parametre == b->parametre && a->graine == b->graine;
+}
+
+/*!
+ * @brief Finds the slot of an entry, or the free slot where it would go.
+ * 
+ * @param cache Pointer to the cache.
+ * @param cle The entry whose parameters are searched.
+ * @return The slot.
+ */
+entree_cache_t *chercher_entree(const cache_t *cache, const entree_cache_t *cle) {
+    uint64_t masque = cache->entete->capacite - 1;
+    entree_cache_t *entrees = entrees_cache(cache);
+    for (uint64_t i = hacher_entree(cle) & masque; ; i = (i + 1) & masque) {
+        if (entrees[i].essais == 0 || memes_parametres(&entrees[i], cle)) return &entrees[i];
+    }
+}
+
+/*!
+ * @brief Maps the whole cache file, after it was created or grown.
+ * 
+ * @param cache Pointer to the cache.
+ * @param taille The size of the file.
+ * @return true if the file was mapped, false otherwise (the previous mapping is kept).
+ */
+bool projeter_cache(cache_t *cache, size_t taille) {
+    void *projection = mmap(NULL, taille, PROT_READ | PROT_WRITE, MAP_SHARED, cache->fd, 0);
+    if (projection == MAP_FAILED) return false;
+    if (cache->entete != NULL) munmap(cache->entete, cache->taille);
+    cache->entete = projection;
+    cache->taille = taille;
+    return true;
+}
+
+/*!
+ * @brief Takes the lock of the cache and follows a growth made by another process.
+ * 
+ * @param cache Pointer to the cache.
+ * @return true if the cache is locked and mapped, false otherwise (the lock is released).
+ */
+bool verrouiller_cache(cache_t *cache) {
+    if (cache->fd < 0 || flock(cache->fd, LOCK_EX) != 0) return false;
+    size_t taille = sizeof(entete_cache_t) + cache->entete->capacite * sizeof(entree_cache_t);
+    if (taille != cache->taille && !projeter_cache(cache, taille)) {
+        flock(cache->fd, LOCK_UN);
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * @brief Closes a result cache.
+ * 
+ * @param cache Pointer to the cache.
+ */
+void fermer_cache(cache_t *cache) {
+    if (cache->entete != NULL) munmap(cache->entete, cache->taille);
+    if (cache->fd >= 0) close(cache->fd);
+    cache->entete = NULL;
+    cache->fd = -1;
+}
+
+/*!
+ * @brief Opens a result cache file, and creates it if it does not exist.
+ * 
+ * @param cache Pointer to the cache to fill.
+ * @param chemin The path of the file.
+ * @return true if the cache was opened, false if the file could not be created or is not a cache.
+ */
+bool ouvrir_cache(cache_t *cache, const char *chemin) {
+    cache->entete = NULL;
+    cache->taille = 0;
+    cache->fd = open(chemin, O_RDWR | O_CREAT, 0644);
+    if (cache->fd < 0) return false;
+    bool valide = flock(cache->fd, LOCK_EX) == 0;
+    struct stat infos;
+    if (valide && fstat(cache->fd, &infos) == 0 && infos.st_size == 0) {
+        size_t taille = sizeof(entete_cache_t) + CAPACITE_CACHE * sizeof(entree_cache_t);
+        valide = ftruncate(cache->fd, taille) == 0 && projeter_cache(cache, taille);
+        if (valide) *cache->entete = (entete_cache_t) {"TPCACHE", FORMAT_CACHE, 0, CAPACITE_CACHE, 0};
+    } else {
+        valide = valide && (size_t) infos.st_size >= sizeof(entete_cache_t) && projeter_cache(cache, infos.st_size);
+        /* la table est sondée avec le masque capacite-1 et doit toujours garder une case libre */
+        valide = valide && memcmp(cache->entete->magie, "TPCACHE", 8) == 0 && cache->entete->format == FORMAT_CACHE
+            && cache->entete->capacite != 0 && (cache->entete->capacite & (cache->entete->capacite - 1)) == 0
+            && cache->entete->capacite <= ((uint64_t) infos.st_size - sizeof(entete_cache_t)) / sizeof(entree_cache_t)
+            && cache->entete->nbr_entrees < cache->entete->capacite
+            && infos.st_size == (off_t) (sizeof(entete_cache_t) + cache->entete->capacite * sizeof(entree_cache_t));
+    }
+    flock(cache->fd, LOCK_UN);
+    if (!valide) fermer_cache(cache);
+    return valide;
+}
+
+/*!
+ * @brief Reads the result of a run from the cache. The threads of the process take turns,
+ * since the lock of the file only keeps other processes out.
+ * 
+ * @param cache Pointer to the cache, or NULL for no cache.
+ * @param entree The parameters of the run, and where to store its result.
+ * @return true if the run is in the cache, false otherwise.
+ */
+bool lire_cache(cache_t *cache, entree_cache_t *entree) {
+    if (cache == NULL) return false;
+    bool present = false;
+    #pragma omp critical(cache)
+    if (verrouiller_cache(cache)) {
+        entree_cache_t *trouvee = chercher_entree(cache, entree);
+        present = trouvee->essais != 0;
+        if (present) *entree = *trouvee;
+        flock(cache->fd, LOCK_UN);
+    }
+    return present;
+}
+
+/*!
+ * @brief Stores an entry in a locked cache, unless it already holds a result of the same run
+ * with more trials. The table doubles when it is half full.
+ * 
+ * @param cache Pointer to the locked cache.
+ * @param entree The run and its result.
+ * @return true if the entry was stored, false if the table could not grow. The cache is
+ * closed if the file could not be given back the size of its table.
+ */
+bool inserer_entree(cache_t *cache, const entree_cache_t *entree) {
+    entete_cache_t *entete = cache->entete;
+    if (2 * (entete->nbr_entrees + 1) > entete->capacite) {
+        uint64_t capacite = entete->capacite;
+        entree_cache_t *anciennes = malloc(capacite * sizeof(entree_cache_t));
+        size_t taille = sizeof(entete_cache_t) + 2 * capacite * sizeof(entree_cache_t);
+        if (anciennes == NULL) return false;
+        memcpy(anciennes, entrees_cache(cache), capacite * sizeof(entree_cache_t));
+        if (ftruncate(cache->fd, taille) != 0 || !projeter_cache(cache, taille)) {
+            free(anciennes);
+            /* la taille du fichier doit rester celle de la table, sinon il ne serait plus reconnu */
+            if (ftruncate(cache->fd, cache->taille) != 0) fermer_cache(cache);
+            return false;
+        }
+        cache->entete->capacite = 2 * capacite;
+        memset(entrees_cache(cache), 0, 2 * capacite * sizeof(entree_cache_t));
+        for (uint64_t i = 0; i < capacite; i++) {
+            if (anciennes[i].essais != 0) *chercher_entree(cache, &anciennes[i]) = anciennes[i];
+        }
+        free(anciennes);
+    }
+    entree_cache_t *place = chercher_entree(cache, entree);
+    if (place->essais == 0) cache->entete->nbr_entrees++;
+    if (place->essais < entree->essais) *place = *entree;
+    return true;
+}
+
+/*!
+ * @brief Writes the result of a run to the cache.
+ * 
+ * @param cache Pointer to the cache, or NULL for no cache.
+ * @param entree The run and its result.
+ */
+void ecrire_cache(cache_t *cache, const entree_cache_t *entree) {
+    if (cache == NULL || entree->essais == 0) return;
+    #pragma omp critical(cache)
+    if (verrouiller_cache(cache)) {
+        /* un cache fermé par inserer_entree a rendu son verrou avec son fichier */
+        inserer_entree(cache, entree);
+        if (cache->fd >= 0) flock(cache->fd, LOCK_UN);
+    }
+}
+
+/*!
+ * @brief Estimates the average number of components until the 95% confidence interval
+ * is narrower than 2*epsilon. The trials are run by batches of LOT_ESSAIS shared between
+ * the threads, then added to the statistics in the order of their index; the stopping
+ * test only happens between batches, so the trials used and the result are the same for
+ * any number of threads. With a cache, the run starts from the trials already in the cache,
+ * which are the first trials of the run.
+ *
+ * @param size The side of the grid.
+ * @param probability The probability of an edge existing between two vertices.
+ * @param diagonal Whether the diagonal neighbors can be linked.
+ * @param graine The seed of the run; trial i draws its graph with the trial index i.
+ * @param moteur The labeling engine.
+ * @param epsilon The wanted half-width of the confidence interval.
+ * @param max_essais The maximum number of trials.
+ * @param cache The result cache, whose trials are reused and extended, or NULL for no cache.
+ * @param reserve The trial contexts kept by the caller between runs, one per thread (zeroed
+ * before the first run), or NULL to create them for this run only.
+ * @return The statistics of the trials run.
+ */
+statistiques_t estimer_composantes(int size, double probability, bool diagonal, uint64_t graine, moteur_t moteur, double epsilon, int64_t max_essais, cache_t *cache, contexte_essai_t *reserve) {
+    statistiques_t stats = {0, 0, 0};
+    entree_cache_t entree = {CACHE_MOYENNE, VERSION_TIRAGE, size, diagonal, probability, graine, 0, 0, 0};
+    if (lire_cache(cache, &entree)) stats = (statistiques_t) {entree.essais, entree.valeur, entree.dispersion};
+    if (stats.essais >= max_essais || statistiques_demi_largeur(&stats) < epsilon) return stats;
+    int64_t *resultats = malloc(LOT_ESSAIS * sizeof(int64_t));
+    int threads = nombre_threads();
+    contexte_essai_t *contextes = reserve != NULL ? reserve : calloc(threads, sizeof(contexte_essai_t));
+    if (resultats == NULL || contextes == NULL) {
+        free(resultats);
+        if (reserve == NULL) free(contextes);
+        return stats;
+    }
+    bool erreur = false;
+    while (stats.essais < max_essais && !erreur) {
+        int64_t debut = stats.essais;
+        int lot = max_essais - debut < LOT_ESSAIS ? (int) (max_essais - debut) : LOT_ESSAIS;
+        #pragma omp parallel
+        {
+            contexte_essai_t *contexte = &contextes[numero_thread()];
+            if (contexte->size != size) {
+                if (contexte->size != 0) detruire_contexte_essai(contexte);
+                *contexte = creer_contexte_essai(size);
+            }
+            #pragma omp for schedule(dynamic, 1)
+            for (int i = 0; i < lot; i++) {
+                resultats[i] = contexte->flux.parent == NULL ? -1 : compter_composantes(moteur, contexte, probability, diagonal, (tirage_t) {graine, (uint32_t) (debut + i)});
+                if (resultats[i] < 0) {
+                    #pragma omp atomic write
+                    erreur = true;
+                }
+            }
+        }
+        if (erreur) break;
+        for (int i = 0; i < lot; i++) statistiques_ajouter(&stats, (double) resultats[i]);
+        if (statistiques_demi_largeur(&stats) < epsilon) break;
+    }
+    if (reserve == NULL) {
+        for (int t = 0; t < threads; t++) if (contextes[t].size != 0) detruire_contexte_essai(&contextes[t]);
+        free(contextes);
+    }
+    free(resultats);
+    entree.essais = stats.essais;
+    entree.valeur = stats.moyenne;
+    entree.dispersion = stats.m2;
+    ecrire_cache(cache, &entree);
+    return stats;
+}
+
+/*!
+ * @brief Calculates the average number of colors used to color a graph of a given size and probability.
+ * Only the number of components is needed, so by default the grids are counted by the
+ * scanline engine and never built. The trials are shared between the threads, which take
+ * the next one as soon as they are free and keep their own trial context; trial i always
+ * draws its grid with the trial index i and the counts are summed as integers, so the
+ * result is the same for any number of threads. With a cache, the trials are those of
+ * estimer_composantes, and an entry with more than k trials answers at once.
+ * 
+ * @param size The number of vertices in the graph.
+ * @param probability The probability of an edge existing between two vertices.
+ * @param graine The seed of the run; trial i draws its graph with the trial index i.
+ * @param moteur The labeling engine.
+ * @param cache The result cache, or NULL for no cache.
+ * @return The average number of colors used to color the graph over k iterations, or NAN if
+ * an allocation failed and some trials could not be run.
+ */
+double moyenne_couleur(int size, double probability, int k, bool diagonal, uint64_t graine, moteur_t moteur, cache_t *cache) {
+    if (cache != NULL) {
+        statistiques_t stats = estimer_composantes(size, probability, diagonal, graine, moteur, 0, k, cache, NULL);
+        return stats.essais >= k ? stats.moyenne : NAN;
+    }
+    int64_t nbr_couleurs_total = 0;
+    int essais = 0;
+    #pragma omp parallel reduction(+:nbr_couleurs_total, essais)
+    {
+        contexte_essai_t contexte = creer_contexte_essai(size);
+        #pragma omp for schedule(dynamic, 1)
+        for (int i = 0; i < k; i++) {
+            if (contexte.flux.parent == NULL) continue;
+            int64_t composantes = compter_composantes(moteur, &contexte, probability, diagonal, (tirage_t) {graine, i});
+            if (composantes < 0) continue;
+            nbr_couleurs_total += composantes;
+            essais++;
+        }
+        detruire_contexte_essai(&contexte);
+    }
+    /* un essai sauté fausserait la moyenne : mieux vaut ne pas en donner */
+    return essais == k ? (double) nbr_couleurs_total/k : NAN;
+}
+
+
+/*!
+ * @brief Lists the edges a grid can have, in the order of the edge stream.
+ * 
+ * @param size The side of the grid.
+ * @param diagonal Whether the diagonal neighbors can be linked.
+ * @param aretes Where to store the array of edges, to be freed by the caller.
+ * @return The number of edges, or -1 if the allocation failed.
+ */
+int64_t lister_aretes_grille(int size, bool diagonal, arete_t **aretes) {
+    int64_t cote = size > 0 ? size - 1 : 0;
+    int64_t nbr_aretes = 2 * cote * size + (diagonal ? cote * cote : 0);
+    *aretes = malloc((nbr_aretes > 0 ? nbr_aretes : 1) * sizeof(arete_t));
+    if (*aretes == NULL) return -1;
+    int64_t m = 0;
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j + 1 < size; j++) (*aretes)[m++] = (arete_t) {i*size+j, i*size+j+1};
+    }
+    for (int i = 0; i + 1 < size; i++) {
+        for (int j = 0; j < size; j++) (*aretes)[m++] = (arete_t) {i*size+j, (i+1)*size+j};
+    }
+    if (diagonal) {
+        for (int i = 0; i + 1 < size; i++) {
+            for (int j = 0; j + 1 < size; j++) (*aretes)[m++] = (arete_t) {i*size+j, (i+1)*size+j+1};
+        }
+    }
+    return nbr_aretes;
+}
+
+/*!
+ * @brief Shuffles the edges of a trial (Fisher-Yates), drawing from the permutation stream,
+ * so the order only depends on the seed and the trial.
+ * 
+ * @param aretes The edges to shuffle.
+ * @param nbr_aretes The number of edges.
+ * @param tirage The seed and trial of the draw.
+ */
+void melanger_aretes(arete_t *aretes, int64_t nbr_aretes, tirage_t tirage) {
+    uint32_t alea[4];
+    for (int64_t j = nbr_aretes - 1; j > 0; j--) {
+        if (j % 2 == 1 || j == nbr_aretes - 1) tirer_bloc(tirage, FLUX_PERMUTATION, j / 2, alea);
+        uint64_t mot = ((uint64_t) alea[2*(j%2)+1] << 32) | alea[2*(j%2)];
+        int64_t r = (int64_t) (mot % (uint64_t) (j + 1));
+        arete_t t = aretes[j];
+        aretes[j] = aretes[r];
+        aretes[r] = t;
+    }
+}
+
+/*!
+ * @brief Runs the Newman-Ziff algorithm: every trial adds all the edges of the grid in a
+ * random order to a union-find and records the number of components after each addition.
+ * The counts are summed as integers, so the result is the same for any number of threads.
+ * 
+ * @param size The side of the grid.
+ * @param diagonal Whether the diagonal neighbors can be linked.
+ * @param essais The number of trials.
+ * @param graine The seed of the run; trial i shuffles the edges with the trial index i.
+ * @param nbr_aretes Where to store the number of edges of the grid.
+ * @return The average number of components with m edges, for m from 0 to nbr_aretes, or NULL if an allocation failed.
+ */
+double *newman_ziff(int size, bool diagonal, int essais, uint64_t graine, int64_t *nbr_aretes) {
+    arete_t *ordre;
+    int64_t m_max = lister_aretes_grille(size, diagonal, &ordre);
+    int n = size * size;
+    int64_t *total = calloc(m_max + 1, sizeof(int64_t));
+    double *moyennes = malloc((m_max + 1) * sizeof(double));
+    if (m_max < 0 || total == NULL || moyennes == NULL) {
+        if (m_max >= 0) free(ordre);
+        free(total);
+        free(moyennes);
+        return NULL;
+    }
+    bool erreur = false;
+    #pragma omp parallel
+    {
+        int64_t *somme = calloc(m_max + 1, sizeof(int64_t));
+        arete_t *aretes = malloc((m_max > 0 ? m_max : 1) * sizeof(arete_t));
+        int *parent = malloc((n > 0 ? n : 1) * sizeof(int));
+        unsigned char *rang = malloc(n > 0 ? n : 1);
+        if (somme == NULL || aretes == NULL || parent == NULL || rang == NULL) {
+            #pragma omp atomic write
+            erreur = true;
+        }
+        #pragma omp for schedule(dynamic, 1)
+        for (int i = 0; i < essais; i++) {
+            bool arret;
+            #pragma omp atomic read
+            arret = erreur;
+            if (arret) continue;
+            memcpy(aretes, ordre, m_max * sizeof(arete_t));
+            melanger_aretes(aretes, m_max, (tirage_t) {graine, i});
+            for (int s = 0; s < n; s++) parent[s] = s;
+            memset(rang, 0, n);
+            int64_t composantes = n;
+            somme[0] += composantes;
+            for (int64_t m = 0; m < m_max; m++) {
+                if (uf_unir(parent, rang, aretes[m].sommet1, aretes[m].sommet2)) composantes--;
+                somme[m+1] += composantes;
+            }
+        }
+        if (somme != NULL) {
+            #pragma omp critical
+            for (int64_t m = 0; m <= m_max; m++) total[m] += somme[m];
+        }
+        free(somme);
+        free(aretes);
+        free(parent);
+        free(rang);
+    }
+    free(ordre);
+    if (erreur) {
+        free(total);
+        free(moyennes);
+        return NULL;
+    }
+    for (int64_t m = 0; m <= m_max; m++) moyennes[m] = (double) total[m] / essais;
+    free(total);
+    *nbr_aretes = m_max;
+    return moyennes;
+}
+
+/*!
+ * @brief Calculates the average number of components at a probability from the averages
+ * at a fixed number of edges, weighted by the binomial distribution of the number of edges.
+ * Only the terms within 12 standard deviations of the mean number of edges are summed.
+ * 
+ * @param moyennes The average number of components with m edges, for m from 0 to nbr_aretes.
+ * @param nbr_aretes The number of edges of the grid.
+ * @param probability The probability of an edge existing between two vertices.
+ * @return The average number of components.
+ */
+double composantes_binomiale(const double *moyennes, int64_t nbr_aretes, double probability) {
+    if (probability <= 0) return moyennes[0];
+    if (probability >= 1) return moyennes[nbr_aretes];
+    double esperance = nbr_aretes * probability;
+    double marge = 12 * sqrt(esperance * (1 - probability)) + 12;
+    int64_t debut = esperance - marge > 0 ? (int64_t) (esperance - marge) : 0;
+    int64_t fin = esperance + marge < nbr_aretes ? (int64_t) (esperance + marge) : nbr_aretes;
+    double log_n = lgamma(nbr_aretes + 1.0), log_p = log(probability), log_q = log1p(-probability);
+    double somme = 0, poids_total = 0;
+    for (int64_t m = debut; m <= fin; m++) {
+        double poids = exp(log_n - lgamma(m + 1.0) - lgamma(nbr_aretes - m + 1.0) + m * log_p + (nbr_aretes - m) * log_q);
+        somme += poids * moyennes[m];
+        poids_total += poids;
+    }
+    return somme / poids_total;
+}
+
+/*!
+ * @brief A bank of threshold indexes: for each sample, the sorted weights of the minimum
+ * spanning forest of the grid whose edges are weighted by their random words.
+ * An edge exists at threshold seuil exactly when its word is below seuil, and the
+ * components of a sample are then the vertices minus the forest edges below seuil.
+ * A full grid is connected, so every forest has nbr_sommets-1 edges.
+ */
+typedef struct {
+    int size; /**< The side of the grids. */
+    bool diagonal; /**< Whether the diagonal neighbors can be linked. */
+    uint64_t graine; /**< The seed of the run. */
+    int echantillons; /**< The number of samples. */
+    int64_t nbr_sommets; /**< The number of vertices of a grid. */
+    uint32_t *poids; /**< The nbr_sommets-1 sorted forest weights of each sample, one after the other. */
+} banque_seuils_t;
+
+/*!
+ * @brief Frees a bank of threshold indexes.
+ * 
+ * @param banque Pointer to the bank.
+ */
+void detruire_banque_seuils(banque_seuils_t *banque) {
+    free(banque->poids);
+    banque->poids = NULL;
+}
+
+/*!
+ * @brief Adds samples to a bank of threshold indexes. Sample i weights the edges with the
+ * words of the edge stream of trial i, as tirer_aretes_dense does, then runs Kruskal on the
+ * edges sorted by weight. The samples are shared between the threads, and a bank extended
+ * in several steps is the same as a bank built at once.
+ * 
+ * @param banque Pointer to the bank.
+ * @param echantillons The new number of samples.
+ * @return true if the samples were added, false if an allocation failed (the bank is unchanged).
+ */
+bool etendre_banque_seuils(banque_seuils_t *banque, int echantillons) {
+    int size = banque->size, premier = banque->echantillons;
+    int64_t n = banque->nbr_sommets, longueur = n > 0 ? n - 1 : 0;
+    if (echantillons <= premier) return true;
+    arete_t *aretes;
+    int64_t nbr_aretes = lister_aretes_grille(size, banque->diagonal, &aretes);
+    if (nbr_aretes < 0) return false;
+    uint32_t *tous = realloc(banque->poids, (echantillons * longueur > 0 ? echantillons * longueur : 1) * sizeof(uint32_t));
+    if (tous == NULL) {
+        free(aretes);
+        return false;
+    }
+    banque->poids = tous;
+    noyau_tirage_t noyau = choisir_noyau_tirage();
+    int64_t nbr_blocs = ((banque->diagonal ? 3 : 2) * n + 3) / 4;
+    bool erreur = false;
+    #pragma omp parallel
+    {
+        uint32_t *alea = malloc(((nbr_blocs + 15) / 16 * 16 * 4) * sizeof(uint32_t));
+        uint64_t *cles = malloc((nbr_aretes > 0 ? nbr_aretes : 1) * sizeof(uint64_t));
+        uint64_t *tampon = malloc((nbr_aretes > 0 ? nbr_aretes : 1) * sizeof(uint64_t));
+        int *parent = malloc((n > 0 ? n : 1) * sizeof(int));
+        unsigned char *rang = malloc(n > 0 ? n : 1);
+        if (alea == NULL || cles == NULL || tampon == NULL || parent == NULL || rang == NULL) {
+            #pragma omp atomic write
+            erreur = true;
+        }
+        #pragma omp for schedule(dynamic, 1)
+        for (int i = premier; i < echantillons; i++) {
+            bool arret;
+            #pragma omp atomic read
+            arret = erreur;
+            if (arret) continue;
+            tirage_t tirage = {banque->graine, i};
+            for (int64_t b = 0; b < nbr_blocs; b += 16 * 1024) {
+                int nombre = nbr_blocs - b < 16 * 1024 ? (int) (nbr_blocs - b) : 16 * 1024;
+                noyau.tirer_blocs(tirage, FLUX_ARETES, b, (nombre + 15) / 16 * 16, alea + 4*b);
+            }
+            for (int64_t m = 0; m < nbr_aretes; m++) {
+                int a = aretes[m].sommet1, b = aretes[m].sommet2;
+                int64_t plan = b == a + 1 ? 0 : b == a + size ? 1 : 2;
+                cles[m] = (uint64_t) alea[plan * n + a] << 32 | (uint64_t) m;
+            }
+            trier_radix(cles, tampon, nbr_aretes);
+            for (int s = 0; s < n; s++) {
+                parent[s] = s;
+                rang[s] = 0;
+            }
+            uint32_t *poids = banque->poids + i * longueur;
+            int64_t k = 0;
+            for (int64_t m = 0; m < nbr_aretes && k < longueur; m++) {
+                arete_t arete = aretes[cles[m] & UINT32_MAX];
+                if (uf_unir(parent, rang, arete.sommet1, arete.sommet2)) poids[k++] = cles[m] >> 32;
+            }
+        }
+        free(alea);
+        free(cles);
+        free(tampon);
+        free(parent);
+        free(rang);
+    }
+    free(aretes);
+    if (!erreur) banque->echantillons = echantillons;
+    return !erreur;
+}
+
+/*!
+ * @brief Builds a bank of threshold indexes.
+ * 
+ * @param size The side of the grids.
+ * @param diagonal Whether the diagonal neighbors can be linked.
+ * @param echantillons The number of samples.
+ * @param graine The seed of the run.
+ * @return The bank, with poids set to NULL if an allocation failed.
+ */
+banque_seuils_t creer_banque_seuils(int size, bool diagonal, int echantillons, uint64_t graine) {
+    banque_seuils_t banque = {size, diagonal, graine, 0, (int64_t) size * size, NULL};
+    if (!etendre_banque_seuils(&banque, echantillons)) detruire_banque_seuils(&banque);
+    return banque;
+}
+
+/*!
+ * @brief Counts the components of a sample of the bank at a threshold, by binary search.
+ * 
+ * @param banque Pointer to the bank.
+ * @param echantillon The index of the sample.
+ * @param seuil The threshold given by seuil_probabilite.
+ * @return The number of connected components.
+ */
+int64_t composantes_echantillon(const banque_seuils_t *banque, int echantillon, uint64_t seuil) {
+    int64_t longueur = banque->nbr_sommets > 0 ? banque->nbr_sommets - 1 : 0;
+    const uint32_t *poids = banque->poids + echantillon * longueur;
+    int64_t debut = 0, fin = longueur;
+    while (debut < fin) {
+        int64_t milieu = debut + (fin - debut) / 2;
+        if (poids[milieu] < seuil) debut = milieu + 1;
+        else fin = milieu;
+    }
+    return banque->nbr_sommets - debut;
+}
+
+/*!
+ * @brief Calculates the average number of components of the samples of the bank at a threshold.
+ * 
+ * @param banque Pointer to the bank.
+ * @param seuil The threshold given by seuil_probabilite.
+ * @return The average number of connected components.
+ */
+double composantes_banque(const banque_seuils_t *banque, uint64_t seuil) {
+    int64_t total = 0;
+    for (int i = 0; i < banque->echantillons; i++) total += composantes_echantillon(banque, i, seuil);
+    return (double) total / banque->echantillons;
+}
+
+/*!
+ * @brief Gives the time elapsed since an arbitrary origin.
+ * 
+ * @return The time in seconds.
+ */
+double horloge(void) {
+#ifdef _OPENMP
+    return omp_get_wtime();
+#else
+    return (double) clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+/*!
+ * @brief Finds the smallest threshold at which the samples of the bank have k components
+ * or less on average. The average is a nonincreasing function of the threshold, so a
+ * bisection on the 32-bit thresholds ends after 33 steps.
+ * 
+ * @param banque Pointer to the bank.
+ * @param k The number of components.
+ * @return The threshold, 2^32 if even the full grids have more than k components.
+ */
+uint64_t seuil_racine(const banque_seuils_t *banque, int k) {
+    uint64_t debut = 0, fin = (uint64_t) 1 << 32;
+    while (debut < fin) {
+        uint64_t milieu = debut + (fin - debut) / 2;
+        if (composantes_banque(banque, milieu) <= k) fin = milieu;
+        else debut = milieu + 1;
+    }
+    return debut;
+}
+
+/*!
+ * @brief The result of the search of the optimal probability.
+ * 
+ */
+typedef struct {
+    double proba; /**< The estimated probability. */
+    double incertitude; /**< The half-width of the 95% confidence interval of the probability. */
+    int echantillons; /**< The number of samples used. */
+    bool converge; /**< Whether the half-width is below the tolerance. */
+} resolution_t;
+
+/*!
+ * @brief Estimates the half-width of the 95% confidence interval of the root found on a bank,
+ * by the delta method: the standard error of the average number of components at the root,
+ * divided by the slope of the average curve around the root.
+ * 
+ * @param banque Pointer to the bank.
+ * @param seuil The threshold of the root.
+ * @return The half-width, in probability.
+ */
+double incertitude_racine(const banque_seuils_t *banque, uint64_t seuil) {
+    /* la racine est entre seuil-1 et seuil : on garde la plus grande des deux erreurs */
+    double erreur = 0;
+    for (uint64_t s = seuil > 0 ? seuil - 1 : 0; s <= seuil; s++) {
+        statistiques_t stats = {0, 0, 0};
+        for (int i = 0; i < banque->echantillons; i++) statistiques_ajouter(&stats, (double) composantes_echantillon(banque, i, s));
+        erreur = fmax(erreur, statistiques_erreur_type(&stats));
+    }
+    if (erreur == 0) return 0;
+    uint64_t ecart = seuil_probabilite(PAS_PENTE);
+    uint64_t bas = seuil > ecart ? seuil - ecart : 0;
+    uint64_t haut = seuil + ecart < ((uint64_t) 1 << 32) ? seuil + ecart : (uint64_t) 1 << 32;
+    double pente = (composantes_banque(banque, bas) - composantes_banque(banque, haut)) / ((haut - bas) / 4294967296.0);
+    return pente > 0 ? Z_CONFIANCE * erreur / pente : INFINITY;
+}
+
+/*!
+ * @brief Calculates the optimal probability for a given graph size and number of colors.
+ * The root is searched on a bank of samples, whose average curve is monotone so the search
+ * always ends, then the bank is grown until the uncertainty of the root is below the
+ * tolerance. Each growth aims at the number of samples the uncertainty asks for, between
+ * twice and sixteen times the current one, and is cut to fit the sample and time budgets.
+ * The first bank is itself built by doublings from two samples, so that the time budget
+ * also bounds it. The bank grows by whole samples of fixed trial indexes, so a run only
+ * depends on the budgets through the number of samples it reaches.
+ * @param size The size of the graph.
+ * @param k The number of colors.
+ * @param graine The seed of the run.
+ * @param tolerance The wanted half-width of the confidence interval of the probability.
+ * @param max_echantillons The maximum number of samples, 0 for as many as MEMOIRE_BANQUE bytes hold.
+ * @param duree_max The time budget in seconds, checked before each growth of the bank,
+ * including the steps of the first one.
+ * @param cache The result cache, or NULL for no cache. A cached result within the tolerance
+ * answers at once, otherwise the bank starts at the number of samples of the cached result.
+ * @return The optimal probability, with a negative proba if the bank could not be built.
+ */
+resolution_t prob_optimale(int size, int k, bool diagonal, uint64_t graine, double tolerance, int64_t max_echantillons, double duree_max, cache_t *cache) {
+    resolution_t resolution = {-1, INFINITY, 0, false};
+    entree_cache_t entree = {CACHE_PROBA, VERSION_TIRAGE, size, diagonal, k, graine, 0, 0, 0};
+    if (lire_cache(cache, &entree) && entree.dispersion <= tolerance) {
+        return (resolution_t) {entree.valeur, entree.dispersion, (int) entree.essais, true};
+    }
+    double debut = horloge();
+    int64_t longueur = (int64_t) size * size > 1 ? (int64_t) size * size - 1 : 1;
+    if (max_echantillons == 0) max_echantillons = MEMOIRE_BANQUE / (longueur * (int64_t) sizeof(uint32_t));
+    if (max_echantillons < 2) max_echantillons = 2;
+    if (max_echantillons > INT32_MAX) max_echantillons = INT32_MAX;
+    int64_t echantillons = entree.essais > BANQUE_ECHANTILLONS ? entree.essais : BANQUE_ECHANTILLONS;
+    if (echantillons > max_echantillons) echantillons = max_echantillons;
+    banque_seuils_t banque = creer_banque_seuils(size, diagonal, 2, graine);
+    if (banque.poids == NULL) return resolution;
+    /* la première banque est construite par doublements, pour que le temps limite la borne aussi */
+    while (banque.echantillons < echantillons) {
+        double ecoule = horloge() - debut;
+        double suivant = fmin(2.0 * banque.echantillons, (double) echantillons);
+        double par_echantillon = ecoule / banque.echantillons;
+        if (par_echantillon > 0) suivant = fmin(suivant, banque.echantillons + (duree_max - ecoule) / par_echantillon);
+        if (suivant < banque.echantillons + 1) break;
+        if (!etendre_banque_seuils(&banque, (int) suivant)) break;
+    }
+    while (true) {
+        uint64_t seuil = seuil_racine(&banque, k);
+        resolution.proba = seuil / 4294967296.0;
+        resolution.echantillons = banque.echantillons;
+        /* même les grilles pleines ont plus de k parties connexes : plus d'échantillons n'y changent rien */
+        if (composantes_banque(&banque, seuil) > k) break;
+        resolution.incertitude = incertitude_racine(&banque, seuil);
+        resolution.converge = resolution.incertitude <= tolerance;
+        if (resolution.converge || banque.echantillons >= max_echantillons) break;
+        /* l'incertitude décroît comme la racine du nombre d'échantillons */
+        double voulu = banque.echantillons * pow(resolution.incertitude / tolerance, 2) * 1.2;
+        double suivant = fmin(fmax(voulu, 2.0 * banque.echantillons), 16.0 * banque.echantillons);
+        double ecoule = horloge() - debut;
+        double par_echantillon = ecoule / banque.echantillons;
+        if (par_echantillon > 0) suivant = fmin(suivant, banque.echantillons + (duree_max - ecoule) / par_echantillon);
+        suivant = fmin(suivant, (double) max_echantillons);
+        if (suivant < banque.echantillons + 1) break;
+        if (!etendre_banque_seuils(&banque, (int) suivant)) break;
+    }
+    detruire_banque_seuils(&banque);
+    if (isfinite(resolution.incertitude)) {
+        entree.essais = resolution.echantillons;
+        entree.valeur = resolution.proba;
+        entree.dispersion = resolution.incertitude;
+        ecrire_cache(cache, &entree);
+    }
+    return resolution;
+}
+
+/**
+ * @brief Display the help message for the program.
+ * 
+ * Usage: ./prog [type d'éxecution] [taille du carré] [diagonale] [option conditionnelle] ...
+ * 
+ * Types d'éxecution :
+ * 
+ * 1 : Génération d'un graphe aléatoire et coloration:
+ *     ./prog 1 [taille grille] [diagonale(true/false)] [probabilité] [ping(true/false)]
+ * 
+ * 2 : Moyenne du nombre de parties connexes pour une taille de grille et une probabilité données
+ *     ./prog 2 [taille grille] [diagonale(true/false)] [probabilité]
+ * 
+ * 3 : Probabilité optimale pour une taille de grille et un nombre de couleurs donnés
+ *     ./prog 3 [taille grille] [diagonale(true/false)] [nombre de couleurs]
+ * 
+ * 4 : Courbe du nombre moyen de parties connexes en fonction de la probabilité (méthode de Newman-Ziff)
+ *     ./prog 4 [taille grille] [diagonale(true/false)] [nombre d'essais]
+ * 
+ * 5 : Nombre moyen de parties connexes pour des probabilités données, sur une banque d'échantillons
+ *     ./prog 5 [taille grille] [diagonale(true/false)] [nombre d'échantillons] [probabilité ...]
+ * 
+ * sweep : Série de calculs des types 2 et 3, un résultat par ligne
+ *     ./prog sweep [fichier de travaux, ou plages comme "n=16..1024:x2, diag=false|true, p=0.1..0.9:0.01"]
+ * 
+ * serve : Serveur répondant aux requêtes des types 1, 2 et 3 sur une socket Unix, une requête par ligne
+ *     ./prog serve [chemin de la socket]
+ * 
+ * load : Relecture d'une grille coloriée enregistrée par --snapshot, écrite au format de --output
+ *     ./prog load [fichier] [ping(true/false)]
+ * 
+ * Options :
+ *     --seed [graine] : graine du générateur aléatoire (par défaut, dérivée de l'heure)
+ *     --engine [dfs|uf|afforest|fusion|flux] : moteur de coloration (types 1 et 2, flux : type 2 seulement)
+ *     --threads [nombre] : nombre de threads (par défaut, un par cœur)
+ *     --epsilon [précision] : type 2, essais jusqu'à ce que l'intervalle de confiance à 95% soit de ± précision
+ *     --max-trials [nombre] : type 2, nombre maximal d'essais (par défaut, 1000 sans --epsilon, 1000000 avec) ;
+ *                             type 3, nombre maximal d'échantillons (par défaut, autant que 1 Gio de banque)
+ *     --tolerance [précision] : type 3, demi-largeur voulue de l'intervalle de confiance à 95% (par défaut, 0.001)
+ *     --time-limit [secondes] : type 3, durée maximale de la recherche (par défaut, 60)
+ *     --cache [fichier] : types 2 et 3, fichier de résultats réutilisés et complétés d'une exécution à l'autre
+ *     --format [csv|json] : sweep, format des résultats (par défaut, csv)
+ *     --output [dot|neato|svg|ppm|png] : type 1, graphe à placer par neato (exemple2.dot), graphe déjà placé
+ *                                pour neato -n2 (exemple2.dot), image SVG (exemple2.svg), ou image PPM
+ *                                ou PNG d'un bloc de pixels par sommet (exemple2.ppm, exemple2.png)
+ *     --output tiles : type 1, pyramide de tuiles PNG de 256x256 pixels (exemple2_tuiles/niveau/x/y.png),
+ *                      écrite bande par bande sans garder la grille en mémoire
+ *     --output quotient : type 1, un sommet par partie connexe, placé en son centre et relié aux parties
+ *                         dont le rectangle englobant touche le sien, pour neato -n2 (exemple2.dot)
+ *     --snapshot [fichier] : type 1, enregistre la grille, ses couleurs, ses paramètres et sa graine
+ *                            dans un fichier binaire relu sans copie par le mode load
+ *     --pixels [côté] : types ppm et png, côté du bloc d'un sommet (par défaut, 1 : un pixel par sommet,
+ *                       sans les arêtes ; au-delà, les arêtes sont dessinées entre les blocs)
+ */
+void display_help(){
+    printf("Usage: ./prog [type d'éxecution] [taille du carré] [diagonale] [option conditionnelle] ...\n");
+    printf("Types d'éxecution :\n");
+    printf("\n1 : Génération d'un graphe aléatoire et coloration:\n");
+    printf("    ./prog 1 [taille grille] [diagonale(true/false)] [probabilité] [ping(true/false)]\n");
+    printf("\n2 : Moyenne du nombre de parties connexes pour une taille de grille et une probabilité données\n");
+    printf("    ./prog 2 [taille grille] [diagonale(true/false)] [probabilité]\n");
+    printf("\n3 : Probabilité optimale pour une taille de grille et un nombre de couleurs donnés\n");
+    printf("    ./prog 3 [taille grille] [diagonale(true/false)] [nombre de couleurs]\n");
+    printf("\n4 : Courbe du nombre moyen de parties connexes en fonction de la probabilité (méthode de Newman-Ziff)\n");
+    printf("    ./prog 4 [taille grille] [diagonale(true/false)] [nombre d'essais]\n");
+    printf("\n5 : Nombre moyen de parties connexes pour des probabilités données, sur une banque d'échantillons\n");
+    printf("    ./prog 5 [taille grille] [diagonale(true/false)] [nombre d'échantillons] [probabilité ...]\n");
+    printf("\nsweep : Série de calculs des types 2 et 3, un résultat par ligne\n");
+    printf("    ./prog sweep [fichier de travaux, ou plages comme \"n=16..1024:x2, diag=false|true, p=0.1..0.9:0.01\"]\n");
+    printf("\nserve : Serveur répondant aux requêtes des types 1, 2 et 3 sur une socket Unix, une requête par ligne\n");
+    printf("    ./prog serve [chemin de la socket]\n");
+    printf("\nload : Relecture d'une grille coloriée enregistrée par --snapshot, écrite au format de --output\n");
+    printf("    ./prog load [fichier] [ping(true/false)]\n");
+    printf("\nOptions :\n");
+    printf("    --seed [graine] : graine du générateur aléatoire (par défaut, dérivée de l'heure)\n");
+    printf("    --engine [dfs|uf|afforest|fusion|flux] : moteur de coloration (types 1 et 2, flux : type 2 seulement)\n");
+    printf("    --threads [nombre] : nombre de threads (par défaut, un par cœur)\n");
+    printf("    --epsilon [précision] : type 2, essais jusqu'à ce que l'intervalle de confiance à 95%% soit de ± précision\n");
+    printf("    --max-trials [nombre] : type 2, nombre maximal d'essais (par défaut, 1000 sans --epsilon, 1000000 avec) ;\n");
+    printf("                            type 3, nombre maximal d'échantillons (par défaut, autant que 1 Gio de banque)\n");
+    printf("    --tolerance [précision] : type 3, demi-largeur voulue de l'intervalle de confiance à 95%% (par défaut, 0.001)\n");
+    printf("    --time-limit [secondes] : type 3, durée maximale de la recherche (par défaut, 60)\n");
+    printf("    --cache [fichier] : types 2 et 3, fichier de résultats réutilisés et complétés d'une exécution à l'autre\n");
+    printf("    --format [csv|json] : sweep, format des résultats (par défaut, csv)\n");
+    printf("    --output [dot|neato|svg|ppm|png] : type 1, graphe à placer par neato (exemple2.dot), graphe déjà placé\n");
+    printf("                               pour neato -n2 (exemple2.dot), image SVG (exemple2.svg), ou image PPM\n");
+    printf("                               ou PNG d'un bloc de pixels par sommet (exemple2.ppm, exemple2.png)\n");
+    printf("    --output tiles : type 1, pyramide de tuiles PNG de %dx%d pixels (exemple2_tuiles/niveau/x/y.png),\n", TAILLE_TUILE, TAILLE_TUILE);
+    printf("                     écrite bande par bande sans garder la grille en mémoire\n");
+    printf("    --snapshot [fichier] : type 1, enregistre la grille, ses couleurs, ses paramètres et sa graine\n");
+    printf("                           dans un fichier binaire relu sans copie par le mode load\n");
+    printf("    --output quotient : type 1, un sommet par partie connexe, placé en son centre et relié aux parties\n");
+    printf("                        dont le rectangle englobant touche le sien, pour neato -n2 (exemple2.dot)\n");
+    printf("    --pixels [côté] : types ppm et png, côté du bloc d'un sommet (par défaut, 1 : un pixel par sommet,\n");
+    printf("                      sans les arêtes ; au-delà, les arêtes sont dessinées entre les blocs)\n");
+}
+
+/*!
+ * @brief The command line options, given as "--name value" anywhere on the command line.
+ * 
+ */
+typedef struct {
+    uint64_t graine; /**< The seed of the random generator. */
+    moteur_t moteur; /**< The labeling engine. */
+    double epsilon; /**< The wanted half-width of the confidence interval, 0 for a fixed number of trials. */
+    int64_t max_essais; /**< The maximum number of trials, 0 for the default. */
+    double tolerance; /**< The wanted half-width of the confidence interval of the optimal probability. */
+    double duree_max; /**< The time budget of the search of the optimal probability, in seconds. */
+    const char *cache; /**< The path of the result cache file, or NULL for no cache. */
+    bool json; /**< Whether a sweep writes JSON instead of CSV. */
+    rendu_t rendu; /**< The output format of mode 1. */
+    int pixels; /**< The side of the block of pixels of a vertex in the images of mode 1. */
+    const char *instantane; /**< The path of the snapshot saved by mode 1, or NULL for none. */
+} options_t;
+
+/*!
+ * @brief Reads the options of the command line and removes them from argv,
+ * so that the positional arguments keep their usual indices.
+ * 
+ * @param argc Pointer to the number of command line arguments, updated.
+ * @param argv The array of command line arguments, compacted.
+ * @param options The options to fill.
+ * @return true if the options are valid, false otherwise.
+ */
+bool lire_options(int *argc, char *argv[], options_t *options) {
+    options->graine = (uint64_t) time(NULL);
+    options->moteur = MOTEUR_DEFAUT;
+    options->epsilon = 0;
+    options->max_essais = 0;
+    options->tolerance = 0.001;
+    options->duree_max = 60;
+    options->cache = NULL;
+    options->json = false;
+    options->rendu = RENDU_DOT;
+    options->pixels = 1;
+    options->instantane = NULL;
+    int garde = 1;
+    for (int i = 1; i < *argc; i++) {
+        if (strncmp(argv[i], "--", 2) != 0 || strcmp(argv[i], "--help") == 0) {
+            argv[garde++] = argv[i];
+            continue;
+        }
+        if (i+1 >= *argc) return false;
+        char *valeur = argv[++i], *fin;
+        if (strcmp(argv[i-1], "--seed") == 0) {
+            options->graine = strtoull(valeur, &fin, 0);
+            if (*fin != '\0') return false;
+        } else if (strcmp(argv[i-1], "--engine") == 0) {
+            if (strcmp(valeur, "dfs") == 0) options->moteur = MOTEUR_DFS;
+            else if (strcmp(valeur, "uf") == 0) options->moteur = MOTEUR_UNION_FIND;
+            else if (strcmp(valeur, "afforest") == 0) options->moteur = MOTEUR_PARALLELE;
+            else if (strcmp(valeur, "fusion") == 0) options->moteur = MOTEUR_FUSION;
+            else if (strcmp(valeur, "flux") == 0) options->moteur = MOTEUR_FLUX;
+            else return false;
+        } else if (strcmp(argv[i-1], "--threads") == 0) {
+            int threads = strtol(valeur, &fin, 10);
+            if (*fin != '\0' || threads < 1) return false;
+#ifdef _OPENMP
+            omp_set_num_threads(threads);
+#endif
+        } else if (strcmp(argv[i-1], "--epsilon") == 0) {
+            options->epsilon = strtod(valeur, &fin);
+            if (*fin != '\0' || !(options->epsilon > 0)) return false;
+        } else if (strcmp(argv[i-1], "--tolerance") == 0) {
+            options->tolerance = strtod(valeur, &fin);
+            if (*fin != '\0' || !(options->tolerance > 0)) return false;
+        } else if (strcmp(argv[i-1], "--time-limit") == 0) {
+            options->duree_max = strtod(valeur, &fin);
+            if (*fin != '\0' || !(options->duree_max >= 0)) return false;
+        } else if (strcmp(argv[i-1], "--cache") == 0) {
+            options->cache = valeur;
+        } else if (strcmp(argv[i-1], "--format") == 0) {
+            if (strcmp(valeur, "csv") != 0 && strcmp(valeur, "json") != 0) return false;
+            options->json = strcmp(valeur, "json") == 0;
+        } else if (strcmp(argv[i-1], "--output") == 0) {
+            if (strcmp(valeur, "dot") == 0) options->rendu = RENDU_DOT;
+            else if (strcmp(valeur, "neato") == 0) options->rendu = RENDU_POSITIONS;
+            else if (strcmp(valeur, "svg") == 0) options->rendu = RENDU_SVG;
+            else if (strcmp(valeur, "ppm") == 0) options->rendu = RENDU_PPM;
+            else if (strcmp(valeur, "png") == 0) options->rendu = RENDU_PNG;
+            else if (strcmp(valeur, "tiles") == 0) options->rendu = RENDU_TUILES;
+            else if (strcmp(valeur, "quotient") == 0) options->rendu = RENDU_QUOTIENT;
+            else return false;
+        } else if (strcmp(argv[i-1], "--snapshot") == 0) {
+            options->instantane = valeur;
+        } else if (strcmp(argv[i-1], "--pixels") == 0) {
+            options->pixels = strtol(valeur, &fin, 10);
+            if (*fin != '\0' || options->pixels < 1 || options->pixels > 64) return false;
+        } else if (strcmp(argv[i-1], "--max-trials") == 0) {
+            options->max_essais = strtoll(valeur, &fin, 10);
+            if (*fin != '\0' || options->max_essais < 1 || options->max_essais > INT32_MAX) return false;
+        } else {
+            return false;
+        }
+    }
+    *argc = garde;
+    argv[garde] = NULL;
+    return true;
+}
+ 
+/*!
+ * @brief A job of a sweep: one run of type 2 or 3.
+ * 
+ */
+typedef struct {
+    int type; /**< 2 for the average number of components, 3 for the optimal probability. */
+    int size; /**< The side of the grid. */
+    bool diagonal; /**< Whether the diagonal neighbors can be linked. */
+    double parametre; /**< The probability (type 2) or the number of components (type 3). */
+} travail_t;
+
+/*!
+ * @brief The result of a job of a sweep.
+ * 
+ */
+typedef struct {
+    double resultat; /**< The average number of components or the optimal probability. */
+    double incertitude; /**< The half-width of the 95% confidence interval of the result. */
+    int64_t essais; /**< The number of trials or samples used. */
+} resultat_travail_t;
+
+/*!
+ * @brief Checks that the parameters of a job are in their range.
+ * 
+ * @param travail The job.
+ * @return true if the job can be run, false otherwise.
+ */
+bool travail_valide(travail_t travail) {
+    if (travail.size < 1) return false;
+    if (travail.type == 2) return travail.parametre >= 0 && travail.parametre <= 1;
+    return travail.type == 3 && travail.parametre >= 0 && travail.parametre <= INT32_MAX && travail.parametre == floor(travail.parametre);
+}
+
+/*!
+ * @brief Reads the values of a field of a range spec: a list "a|b|c", an arithmetic range
+ * "a..b:pas" (step 1 by default) or a geometric range "a..b:xfacteur".
+ * 
+ * @param texte The values, modified by the parsing.
+ * @param valeurs The stb_ds array the values are appended to.
+ * @return true if the values are valid, false otherwise.
+ */
+bool lire_valeurs(char *texte, double **valeurs) {
+    char *fin, *suite;
+    char *points = strstr(texte, "..");
+    if (points == NULL) {
+        for (char *morceau = strtok_r(texte, "|", &suite); morceau != NULL; morceau = strtok_r(NULL, "|", &suite)) {
+            arrput(*valeurs, strtod(morceau, &fin));
+            if (fin == morceau || *fin != '\0') return false;
+        }
+        return true;
+    }
+    *points = '\0';
+    char *pas_texte = strchr(points + 2, ':');
+    if (pas_texte != NULL) *pas_texte++ = '\0';
+    double debut = strtod(texte, &fin);
+    if (fin == texte || *fin != '\0') return false;
+    double borne = strtod(points + 2, &fin);
+    if (fin == points + 2 || *fin != '\0') return false;
+    bool geometrique = pas_texte != NULL && *pas_texte == 'x';
+    double pas = 1;
+    if (pas_texte != NULL) {
+        pas = strtod(pas_texte + geometrique, &fin);
+        if (fin == pas_texte + geometrique || *fin != '\0') return false;
+    }
+    if (geometrique) {
+        if (!(pas > 1) || !(debut > 0)) return false;
+        for (double v = debut; v <= borne * (1 + 1e-9); v *= pas) arrput(*valeurs, v);
+    } else {
+        if (!(pas > 0)) return false;
+        int64_t nombre = (int64_t) floor((borne - debut) / pas + 1e-9) + 1;
+        for (int64_t i = 0; i < nombre; i++) arrput(*valeurs, debut + i * pas);
+    }
+    return true;
+}
+
+/*!
+ * @brief Reads the jobs of a range spec such as "n=16..1024:x2, diag=false|true, p=0.1..0.9:0.01".
+ * The fields are n (the side), diag (false by default) and either p (type 2) or k (type 3);
+ * the jobs are all the combinations, n varying the slowest.
+ * 
+ * @param description The range spec.
+ * @param travaux The stb_ds array the jobs are appended to.
+ * @return true if the spec is valid, false otherwise.
+ */
+bool lire_travaux_plages(const char *description, travail_t **travaux) {
+    char *copie = strdup(description), *suite;
+    double *tailles = NULL, *parametres = NULL;
+    bool *diagonales = NULL;
+    int type = 0;
+    bool valide = copie != NULL;
+    for (char *champ = valide ? strtok_r(copie, ",", &suite) : NULL; champ != NULL && valide; champ = strtok_r(NULL, ",", &suite)) {
+        while (*champ == ' ') champ++;
+        char *egal = strchr(champ, '=');
+        if (egal == NULL) {
+            valide = false;
+            break;
+        }
+        *egal = '\0';
+        char *valeur = egal + 1, *espace;
+        while (*valeur == ' ') valeur++;
+        while ((espace = strrchr(valeur, ' ')) != NULL && espace[1] == '\0') *espace = '\0';
+        if (strcmp(champ, "n") == 0) {
+            valide = lire_valeurs(valeur, &tailles);
+        } else if (strcmp(champ, "p") == 0 || strcmp(champ, "k") == 0) {
+            valide = type == 0 && lire_valeurs(valeur, &parametres);
+            type = champ[0] == 'p' ? 2 : 3;
+        } else if (strcmp(champ, "diag") == 0) {
+            char *sous_suite;
+            for (char *morceau = strtok_r(valeur, "|", &sous_suite); morceau != NULL && valide; morceau = strtok_r(NULL, "|", &sous_suite)) {
+                valide = strcmp(morceau, "true") == 0 || strcmp(morceau, "false") == 0;
+                arrput(diagonales, strcmp(morceau, "true") == 0);
+            }
+        } else {
+            valide = false;
+        }
+    }
+    if (diagonales == NULL) arrput(diagonales, false);
+    valide = valide && type != 0 && arrlen(tailles) > 0 && arrlen(parametres) > 0;
+    for (ptrdiff_t a = 0; valide && a < arrlen(tailles); a++) {
+        for (ptrdiff_t b = 0; b < arrlen(diagonales); b++) {
+            for (ptrdiff_t c = 0; c < arrlen(parametres); c++) {
+                travail_t travail = {type, (int) tailles[a], diagonales[b], parametres[c]};
+                valide = valide && tailles[a] == travail.size && travail_valide(travail);
+                arrput(*travaux, travail);
+            }
+        }
+    }
+    arrfree(tailles);
+    arrfree(diagonales);
+    arrfree(parametres);
+    free(copie);
+    return valide;
+}
+
+/*!
+ * @brief Reads the jobs of a job file, one job per line written as the arguments of the
+ * program: "2 [taille grille] [diagonale] [probabilité]" or "3 [taille grille] [diagonale]
+ * [nombre de couleurs]". Empty lines and lines starting with # are skipped.
+ * 
+ * @param fichier The job file.
+ * @param travaux The stb_ds array the jobs are appended to.
+ * @return true if every line is a valid job, false otherwise, after the number of the first
+ * invalid line is written on stderr.
+ */
+bool lire_travaux_fichier(FILE *fichier, travail_t **travaux) {
+    char ligne[256], diagonale[8];
+    for (int numero = 1; fgets(ligne, sizeof(ligne), fichier) != NULL; numero++) {
+        char *debut = ligne + strspn(ligne, " \t");
+        /* une ligne plus longue que le tampon serait lue en plusieurs travaux */
+        bool valide = strchr(ligne, '\n') != NULL || feof(fichier);
+        if (valide && (*debut == '#' || *debut == '\n' || *debut == '\0')) continue;
+        travail_t travail;
+        valide = valide && sscanf(debut, "%d %d %7s %lf", &travail.type, &travail.size, diagonale, &travail.parametre) == 4
+            && (strcmp(diagonale, "true") == 0 || strcmp(diagonale, "false") == 0);
+        travail.diagonal = valide && strcmp(diagonale, "true") == 0;
+        if (!valide || !travail_valide(travail)) {
+            fprintf(stderr, "Travail invalide ligne %d\n", numero);
+            return false;
+        }
+        arrput(*travaux, travail);
+    }
+    return true;
+}
+
+/*!
+ * @brief Runs a job of a sweep with the options of the command line.
+ * 
+ * @param travail The job.
+ * @param options The options of the command line.
+ * @param cache The result cache, or NULL for no cache.
+ * @param reserve The trial contexts to reuse, one per thread of the run, or NULL.
+ * @return The result of the job.
+ */
+resultat_travail_t executer_travail(travail_t travail, const options_t *options, cache_t *cache, contexte_essai_t *reserve) {
+    if (travail.type == 3) {
+        resolution_t resolution = prob_optimale(travail.size, (int) travail.parametre, travail.diagonal, options->graine, options->tolerance, options->max_essais, options->duree_max, cache);
+        return (resultat_travail_t) {resolution.proba, resolution.incertitude, resolution.echantillons};
+    }
+    int64_t max_essais = options->max_essais != 0 ? options->max_essais : options->epsilon > 0 ? 1000000 : 1000;
+    statistiques_t stats = estimer_composantes(travail.size, travail.parametre, travail.diagonal, options->graine, options->moteur, options->epsilon, max_essais, cache, reserve);
+    return (resultat_travail_t) {stats.moyenne, statistiques_demi_largeur(&stats), stats.essais};
+}
+
+/*!
+ * @brief Writes the result of a job as a CSV row or a JSON object on one line.
+ * 
+ * @param sortie The stream to write to.
+ * @param travail The job.
+ * @param resultat The result of the job.
+ * @param json Whether to write JSON instead of CSV.
+ */
+void ecrire_resultat_travail(FILE *sortie, travail_t travail, resultat_travail_t resultat, bool json) {
+    const char *diagonale = travail.diagonal ? "true" : "false";
+    if (!json) {
+        fprintf(sortie, "%d,%d,%s,%g,%f,%f,%lld\n", travail.type, travail.size, diagonale, travail.parametre, resultat.resultat, resultat.incertitude, (long long) resultat.essais);
+    } else {
+        fprintf(sortie, "{\"type\": %d, \"taille\": %d, \"diagonale\": %s, \"parametre\": %g, \"resultat\": %f, \"incertitude\": ", travail.type, travail.size, diagonale, travail.parametre, resultat.resultat);
+        if (isfinite(resultat.incertitude)) fprintf(sortie, "%f", resultat.incertitude);
+        else fprintf(sortie, "null");
+        fprintf(sortie, ", \"essais\": %lld}\n", (long long) resultat.essais);
+    }
+    fflush(sortie);
+}
+
+/*!
+ * @brief Runs a sweep: a list of jobs of types 2 and 3 read from a job file or a range spec,
+ * whose results are written in the order of the jobs as soon as they are known.
+ * When there are at least as many jobs as threads, each thread runs whole jobs and keeps its
+ * trial contexts from one job to the next; otherwise the jobs run one after the other, each
+ * on all the threads. Every job gives the same result as when run alone.
+ * 
+ * @param description The path of a job file, or a range spec.
+ * @param options The options of the command line.
+ * @param cache The result cache, or NULL for no cache.
+ * @return true if the jobs are valid, false otherwise.
+ */
+bool balayage(const char *description, const options_t *options, cache_t *cache) {
+    travail_t *travaux = NULL;
+    FILE *fichier = fopen(description, "r");
+    bool valide = fichier != NULL ? lire_travaux_fichier(fichier, &travaux) : lire_travaux_plages(description, &travaux);
+    if (fichier != NULL) fclose(fichier);
+    int nombre = (int) arrlen(travaux), threads = nombre_threads();
+    contexte_essai_t *reserves = calloc(threads, sizeof(contexte_essai_t));
+    if (!valide || nombre == 0 || reserves == NULL) {
+        arrfree(travaux);
+        free(reserves);
+        return false;
+    }
+    if (!options->json) printf("type,taille,diagonale,parametre,resultat,incertitude,essais\n");
+    bool par_travail = nombre >= threads;
+    #pragma omp parallel for schedule(dynamic, 1) ordered if (par_travail)
+    for (int i = 0; i < nombre; i++) {
+        resultat_travail_t resultat = executer_travail(travaux[i], options, cache, par_travail ? &reserves[numero_thread()] : NULL);
+        #pragma omp ordered
+        ecrire_resultat_travail(stdout, travaux[i], resultat, options->json);
+    }
+    for (int t = 0; t < threads; t++) if (reserves[t].size != 0) detruire_contexte_essai(&reserves[t]);
+    free(reserves);
+    arrfree(travaux);
+    return true;
+}
+
+/*!
+ * @brief Answers one request of the server, written as the arguments of the program:
+ * "1 [taille] [diagonale] [probabilité] [pin]", "2 [taille] [diagonale] [probabilité]" or
+ * "3 [taille] [diagonale] [nombre de couleurs]". Types 2 and 3 get the JSON line of a sweep;
+ * type 1 gets a JSON line with the number of colors, followed by the colored graph in the
+ * format of --output, whose last line is "}" (Graphviz) or "</svg>" (SVG).
+ * 
+ * @param requete The request, without its end of line.
+ * @param sortie The stream of the client.
+ * @param options The options of the command line.
+ * @param cache The result cache, or NULL for no cache.
+ * @param reserves The trial contexts of the server, one per thread.
+ * @param arene The arena of the server, reset before a request of type 1.
+ */
+void repondre_requete(const char *requete, FILE *sortie, const options_t *options, cache_t *cache, contexte_essai_t *reserves, arene_t *arene) {
+    travail_t travail;
+    char diagonale[8] = "", pin[8] = "false";
+    int lus = sscanf(requete, "%d %d %7s %lf %7s", &travail.type, &travail.size, diagonale, &travail.parametre, pin);
+    travail.diagonal = strcmp(diagonale, "true") == 0;
+    if (lus >= 4 && travail.type == 1 && travail.size >= 1 && travail.parametre >= 0 && travail.parametre <= 1 && options->moteur != MOTEUR_FLUX && options->rendu != RENDU_TUILES) {
+        arene_reinitialiser(arene);
+        /* le graphe passe par un fichier temporaire pour que son nombre de couleurs soit envoyé avant lui */
+        FILE *dot = tmpfile();
+        bool image = options->rendu == RENDU_PPM || options->rendu == RENDU_PNG;
+        int nbr_couleurs = -1;
+        if (dot != NULL && image) nbr_couleurs = exo_coloration_image(dot, travail.size, travail.parametre, travail.diagonal, (tirage_t) {options->graine, 0}, options->moteur, options->pixels, options->rendu == RENDU_PNG);
+        else if (dot != NULL && options->rendu == RENDU_QUOTIENT) nbr_couleurs = exo_coloration_quotient(dot, travail.size, travail.parametre, travail.diagonal, (tirage_t) {options->graine, 0}, options->moteur);
+        else if (dot != NULL) nbr_couleurs = exo_coloration_graphviz(dot, travail.size, travail.parametre, travail.diagonal, strcmp(pin, "true") == 0, (tirage_t) {options->graine, 0}, options->moteur, arene, options->rendu);
+        if (nbr_couleurs < 0) {
+            fprintf(sortie, "{\"erreur\": \"allocation\"}\n");
+        } else if (image) {
+            /* une image est binaire : sa taille en octets dit au client où elle s'arrête */
+            fprintf(sortie, "{\"type\": 1, \"taille\": %d, \"diagonale\": %s, \"parametre\": %g, \"couleurs\": %d, \"octets\": %ld}\n", travail.size, travail.diagonal ? "true" : "false", travail.parametre, nbr_couleurs, ftell(dot));
+        } else {
+            fprintf(sortie, "{\"type\": 1, \"taille\": %d, \"diagonale\": %s, \"parametre\": %g, \"couleurs\": %d}\n", travail.size, travail.diagonal ? "true" : "false", travail.parametre, nbr_couleurs);
+        }
+        if (nbr_couleurs >= 0) {
+            rewind(dot);
+            char tampon[BUFSIZE];
+            size_t octets;
+            while ((octets = fread(tampon, 1, sizeof(tampon), dot)) > 0) fwrite(tampon, 1, octets, sortie);
+        }
+        if (dot != NULL) fclose(dot);
+    } else if (lus >= 4 && travail_valide(travail)) {
+        ecrire_resultat_travail(sortie, travail, executer_travail(travail, options, cache, reserves), true);
+    } else {
+        fprintf(sortie, "{\"erreur\": \"requête invalide\"}\n");
+    }
+    fflush(sortie);
+}
+
+/*!
+ * @brief Runs the server: listens on a Unix socket and answers the requests of the clients,
+ * one request per line, until a client sends "quit". The clients are served one after the
+ * other, and the threads, trial contexts, arena and cache are kept between requests.
+ * 
+ * @param chemin The path of the socket. An old socket at this path is replaced.
+ * @param options The options of the command line.
+ * @param cache The result cache, or NULL for no cache.
+ * @return true if the server stopped on a "quit" request, false if the socket could not be opened
+ * or stopped accepting clients.
+ */
+bool servir(const char *chemin, const options_t *options, cache_t *cache) {
+    struct sockaddr_un adresse = {0};
+    adresse.sun_family = AF_UNIX;
+    if (strlen(chemin) >= sizeof(adresse.sun_path)) return false;
+    strcpy(adresse.sun_path, chemin);
+    struct stat infos;
+    if (lstat(chemin, &infos) == 0 && S_ISSOCK(infos.st_mode)) unlink(chemin);
+    int ecoute = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (ecoute < 0) return false;
+    if (bind(ecoute, (struct sockaddr *) &adresse, sizeof(adresse)) != 0 || listen(ecoute, SOMAXCONN) != 0) {
+        close(ecoute);
+        return false;
+    }
+    /* un client qui part avant sa réponse ne doit pas arrêter le serveur */
+    signal(SIGPIPE, SIG_IGN);
+    int threads = nombre_threads();
+    contexte_essai_t *reserves = calloc(threads, sizeof(contexte_essai_t));
+    arene_t arene = {0};
+    bool arret = reserves == NULL, erreur = reserves == NULL;
+    while (!arret) {
+        int client = accept(ecoute, NULL, NULL);
+        if (client < 0) {
+            /* trop de fichiers ouverts ou plus de mémoire : attendre qu'il s'en libère, sans boucler à vide */
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) sleep(1);
+            else if (errno != EINTR && errno != ECONNABORTED) erreur = arret = true;
+            continue;
+        }
+        int copie = dup(client);
+        FILE *entree = fdopen(client, "r");
+        FILE *sortie = copie >= 0 ? fdopen(copie, "w") : NULL;
+        char requete[256];
+        while (entree != NULL && sortie != NULL && fgets(requete, sizeof(requete), entree) != NULL) {
+            if (strchr(requete, '\n') == NULL && !feof(entree)) {
+                /* une ligne trop longue est jetée en entier, plutôt que son début lu comme une autre requête */
+                int c;
+                while ((c = fgetc(entree)) != EOF && c != '\n') {}
+                fprintf(sortie, "{\"erreur\": \"requête trop longue\"}\n");
+                fflush(sortie);
+                continue;
+            }
+            requete[strcspn(requete, "\r\n")] = '\0';
+            if (strcmp(requete, "quit") == 0) {
+                arret = true;
+                break;
+            }
+            if (requete[0] != '\0') repondre_requete(requete, sortie, options, cache, reserves, &arene);
+        }
+        if (entree != NULL) fclose(entree);
+        else close(client);
+        if (sortie != NULL) fclose(sortie);
+        else if (copie >= 0) close(copie);
+    }
+    for (int t = 0; reserves != NULL && t < threads; t++) if (reserves[t].size != 0) detruire_contexte_essai(&reserves[t]);
+    free(reserves);
+    arene_detruire(&arene);
+    close(ecoute);
+    unlink(chemin);
+    return !erreur;
 }
- 
\ No newline at end of file
@@ -18,14 +18,80 @@
  */
 int main(int argc, char *argv[]) {
 
+    options_t options;
+    if (!lire_options(&argc, argv, &options)) {
+        display_help();
+        return 1;
+    }
+
     if (argc < 2 || strcmp("--help", argv[1]) == 0) {
         display_help();
         return 0;
     }
 
+    cache_t cache = {-1, 0, NULL};
+    if (options.cache != NULL && !ouvrir_cache(&cache, options.cache)) {
+        fprintf(stderr, "Impossible d'ouvrir le cache %s\n", options.cache);
+        return 1;
+    }
+    cache_t *resultats = options.cache != NULL ? &cache : NULL;
+
+    if (strcmp("sweep", argv[1]) == 0) {
+        if (argc < 3 || !balayage(argv[2], &options, resultats)) {
+            display_help();
+            return 1;
+        }
+        fermer_cache(&cache);
+        return 0;
+    }
+
+    if (strcmp("serve", argv[1]) == 0) {
+        if (argc < 3) {
+            display_help();
+            return 1;
+        }
+        if (!servir(argv[2], &options, resultats)) {
+            fprintf(stderr, "Erreur de la socket %s\n", argv[2]);
+            return 1;
+        }
+        fermer_cache(&cache);
+        return 0;
+    }
+
+    if (strcmp("load", argv[1]) == 0) {
+        instantane_t instantane;
+        if (argc < 3 || options.rendu == RENDU_TUILES) {
+            display_help();
+            return 1;
+        }
+        if (!ouvrir_instantane(&instantane, argv[2])) {
+            fprintf(stderr, "Impossible de lire la grille %s\n", argv[2]);
+            return 1;
+        }
+        const entete_instantane_t *entete = instantane.entete;
+        const char *fichiers[] = {"exemple2.dot", "exemple2.dot", "exemple2.svg", "exemple2.ppm", "exemple2.png", "exemple2_tuiles", "exemple2.dot"};
+        FILE *f = fopen(fichiers[options.rendu], "wb");
+        if (f == NULL) {
+            fprintf(stderr, "Impossible de créer %s\n", fichiers[options.rendu]);
+            fermer_instantane(&instantane);
+            return 1;
+        }
+        bool valide = rendre_grille(f, &instantane.grille, instantane.couleurs, entete->nbr_couleurs, options.rendu, argc > 3 && strcmp("true", argv[3]) == 0, options.pixels);
+        valide = fclose(f) == 0 && valide;
+        fprintf(stdout, "\n Grille %d*%d, diagonale %s, probabilité %f, graine %llu\n", entete->size, entete->size, entete->diagonal ? "true" : "false", entete->probabilite, (unsigned long long) entete->graine);
+        fprintf(stdout, "\n Nombre de couleur : %lld\n", (long long) entete->nbr_couleurs);
+        fermer_instantane(&instantane);
+        if (!valide) {
+            fprintf(stderr, "Erreur d'allocation ou d'écriture\n");
+            return 1;
+        }
+        fprintf(stdout, "\n Graphe écrit dans %s\n", fichiers[options.rendu]);
+        return 0;
+    }
+
     switch (atoi(argv[1])) {
         case 1: {
-            if (argc < 4) {
+            if (argc < 5) {
                 display_help();
                 return 1;
             }
@@ -34,22 +100,46 @@ int main(int argc, char *argv[]) {
             bool diagonal = false;
             bool pin = false;
             if (strcmp("true", argv[3]) == 0) diagonal = true;
-            if (strcmp("true",argv[5])==0) pin = true;
-            else diagonal = false;
-            graphe_t graphe = exo_coloration_step1(size_int, probability_double, diagonal);
-            int *couleurs = calloc(graphe.nbr_sommets, sizeof(int));
-            int nbr_couleurs = exo_coloration_step2(graphe, couleurs);
-            FILE *f = fopen("exemple2.dot", "w");   
-            write_graphviz3(f, graphe, couleurs, pin);
-            fclose(f);
-            detruire_graphe(&graphe);
-            free(couleurs);
-            fprintf(stdout,"\n Nombre de couleur : %d\n",nbr_couleurs);
-            fprintf(stdout,"\n make display pour afficher le graphe\n");
+            if (argc > 5 && strcmp("true",argv[5])==0) pin = true;
+            if (options.moteur == MOTEUR_FLUX) {
+                display_help();
+                return 1;
+            }
+            /* un nom de fichier par format de sortie, dans l'ordre de rendu_t */
+            const char *fichiers[] = {"exemple2.dot", "exemple2.dot", "exemple2.svg", "exemple2.ppm", "exemple2.png", "exemple2_tuiles", "exemple2.dot"};
+            int64_t nbr_couleurs;
+            FILE *f = NULL;
+            if (options.rendu != RENDU_TUILES) {
+                f = fopen(fichiers[options.rendu], "wb");
+                if (f == NULL) {
+                    fprintf(stderr, "Impossible de créer %s\n", fichiers[options.rendu]);
+                    return 1;
+                }
+            }
+            if (options.instantane != NULL && options.rendu != RENDU_TUILES) {
+                nbr_couleurs = exo_coloration_instantane(options.instantane, f, size_int, probability_double, diagonal, pin, (tirage_t) {options.graine, 0}, options.moteur, options.rendu, options.pixels);
+            } else if (options.rendu == RENDU_TUILES) {
+                nbr_couleurs = exo_coloration_tuiles(fichiers[options.rendu], size_int, probability_double, diagonal, (tirage_t) {options.graine, 0});
+            } else {
+                if (options.rendu == RENDU_PPM || options.rendu == RENDU_PNG) nbr_couleurs = exo_coloration_image(f, size_int, probability_double, diagonal, (tirage_t) {options.graine, 0}, options.moteur, options.pixels, options.rendu == RENDU_PNG);
+                else if (options.rendu == RENDU_QUOTIENT) nbr_couleurs = exo_coloration_quotient(f, size_int, probability_double, diagonal, (tirage_t) {options.graine, 0}, options.moteur);
+                else nbr_couleurs = exo_coloration_graphviz(f, size_int, probability_double, diagonal, pin, (tirage_t) {options.graine, 0}, options.moteur, NULL, options.rendu);
+            }
+            /* les dernières écritures ne peuvent échouer qu'à la fermeture */
+            if (f != NULL && fclose(f) != 0) nbr_couleurs = -1;
+            if (nbr_couleurs < 0) {
+                fprintf(stderr, "Erreur d'allocation ou d'écriture\n");
+                return 1;
+            }
+            fprintf(stdout,"\n Nombre de couleur : %lld\n",(long long) nbr_couleurs);
+            if (options.rendu == RENDU_TUILES) fprintf(stdout,"\n Tuiles écrites dans %s/niveau/x/y.png\n", fichiers[options.rendu]);
+            else if (options.rendu == RENDU_SVG || options.rendu == RENDU_PPM || options.rendu == RENDU_PNG) fprintf(stdout,"\n %s s'ouvre dans un visualiseur d'images\n", fichiers[options.rendu]);
+            else if (options.rendu == RENDU_POSITIONS || options.rendu == RENDU_QUOTIENT) fprintf(stdout,"\n make display-positions pour afficher le graphe\n");
+            else fprintf(stdout,"\n make display pour afficher le graphe\n");
             return 0;
         }
         case 2: {
-            if (argc < 4) {
+            if (argc < 5) {
                 display_help();
                 return 1;
             }
@@ -58,11 +148,33 @@ int main(int argc, char *argv[]) {
             bool diagonal;
             if (strcmp("true", argv[3]) == 0) diagonal = true;
             else diagonal = false;
-            fprintf(stdout, "\n La moyenne du nombre de parties connexes pour une grille de %d*%d et un probabilité de %f : %f\n",size_int, size_int, probability_double, moyenne_couleur(size_int, probability_double,1000, diagonal));
+            if (options.epsilon == 0) {
+                int essais = options.max_essais != 0 ? (int) options.max_essais : 1000;
+                double moyenne = moyenne_couleur(size_int, probability_double, essais, diagonal, options.graine, options.moteur, resultats);
+                if (isnan(moyenne)) {
+                    fprintf(stderr, "Erreur d'allocation\n");
+                    return 1;
+                }
+                fprintf(stdout, "\n La moyenne du nombre de parties connexes pour une grille de %d*%d et un probabilité de %f : %f\n",size_int, size_int, probability_double, moyenne);
+                fermer_cache(&cache);
+                return 0;
+            }
+            int64_t max_essais = options.max_essais != 0 ? options.max_essais : 1000000;
+            statistiques_t stats = estimer_composantes(size_int, probability_double, diagonal, options.graine, options.moteur, options.epsilon, max_essais, resultats, NULL);
+            if (stats.essais == 0) {
+                fprintf(stderr, "Erreur d'allocation\n");
+                return 1;
+            }
+            double demi_largeur = statistiques_demi_largeur(&stats);
+            fprintf(stdout, "\n La moyenne du nombre de parties connexes pour une grille de %d*%d et un probabilité de %f : %f\n",size_int, size_int, probability_double, stats.moyenne);
+            fprintf(stdout, " Erreur type : %f\n", statistiques_erreur_type(&stats));
+            fprintf(stdout, " Intervalle de confiance à 95%% : [%f, %f]\n", stats.moyenne - demi_largeur, stats.moyenne + demi_largeur);
+            fprintf(stdout, " Essais : %lld%s\n", (long long) stats.essais, demi_largeur < options.epsilon ? "" : " (précision non atteinte)");
+            fermer_cache(&cache);
             return 0;
         }
         case 3: {
-            if (argc < 4) {
+            if (argc < 5) {
                 display_help();
                 return 1;
             }
@@ -71,7 +183,72 @@ int main(int argc, char *argv[]) {
             bool diagonal;
             if (strcmp("true", argv[3]) == 0) diagonal = true;
             else diagonal = false;
-            fprintf(stdout, "\nLa probailité optimale pour avoir %d parties connexes à partir d'une grille %d*%d est : %f\n",k_int,size_int,size_int,prob_optimale(size_int, k_int, diagonal));
+            resolution_t resolution = prob_optimale(size_int, k_int, diagonal, options.graine, options.tolerance, options.max_essais, options.duree_max, resultats);
+            if (resolution.proba < 0) {
+                fprintf(stderr, "Erreur d'allocation\n");
+                return 1;
+            }
+            fprintf(stdout, "\nLa probailité optimale pour avoir %d parties connexes à partir d'une grille %d*%d est : %f\n",k_int,size_int,size_int,resolution.proba);
+            fprintf(stdout, " Incertitude (95%%) : ± %f\n", resolution.incertitude);
+            fprintf(stdout, " Échantillons : %d%s\n", resolution.echantillons, resolution.converge ? "" : " (tolérance non atteinte)");
+            fermer_cache(&cache);
+            return 0;
+        }
+        case 4: {
+            if (argc < 5) {
+                display_help();
+                return 1;
+            }
+            int size_int = atoi(argv[2]);
+            int essais_int = atoi(argv[4]);
+            bool diagonal;
+            if (strcmp("true", argv[3]) == 0) diagonal = true;
+            else diagonal = false;
+            if (essais_int < 1) {
+                display_help();
+                return 1;
+            }
+            int64_t nbr_aretes;
+            double *moyennes = newman_ziff(size_int, diagonal, essais_int, options.graine, &nbr_aretes);
+            if (moyennes == NULL) {
+                fprintf(stderr, "Erreur d'allocation\n");
+                return 1;
+            }
+            fprintf(stdout, "# probabilité\tparties connexes (grille %d*%d, %d essais)\n", size_int, size_int, essais_int);
+            for (int i = 0; i <= POINTS_COURBE; i++) {
+                double p = (double) i / POINTS_COURBE;
+                fprintf(stdout, "%f\t%f\n", p, composantes_binomiale(moyennes, nbr_aretes, p));
+            }
+            free(moyennes);
+            return 0;
+        }
+        case 5: {
+            if (argc < 5) {
+                display_help();
+                return 1;
+            }
+            int size_int = atoi(argv[2]);
+            int echantillons_int = atoi(argv[4]);
+            bool diagonal;
+            if (strcmp("true", argv[3]) == 0) diagonal = true;
+            else diagonal = false;
+            if (echantillons_int < 1) {
+                display_help();
+                return 1;
+            }
+            banque_seuils_t banque = creer_banque_seuils(size_int, diagonal, echantillons_int, options.graine);
+            if (banque.poids == NULL) {
+                fprintf(stderr, "Erreur d'allocation\n");
+                return 1;
+            }
+            /* les probabilités viennent de la ligne de commande, sinon de l'entrée standard */
+            char ligne[256];
+            for (int i = 5; argc > 5 ? i < argc : fgets(ligne, sizeof(ligne), stdin) != NULL; i++) {
+                double p = atof(argc > 5 ? argv[i] : ligne);
+                fprintf(stdout, "%f\t%f\n", p, composantes_banque(&banque, seuil_probabilite(p)));
+                fflush(stdout);
+            }
+            detruire_banque_seuils(&banque);
             return 0;
         }
         default: {